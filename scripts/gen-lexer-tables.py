@@ -0,0 +1,261 @@
+#!/bin/env python3
+
+"""
+Generate src/lexer/lex-tables.h and src/lexer/lex-tables.c - the character
+class table, the operator state machine and the keyword hash table used by the
+lexer.
+
+Operators are read from the operator_defs table in src/api/operator.c, so
+adding an operator there and re-running this script is all the lexer needs.
+The other punctuation tokens and the keywords are listed below.
+
+Usage (from the repository root):
+    python3 scripts/gen-lexer-tables.py
+"""
+
+import os.path
+import re
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+OPERATOR_C = os.path.join(ROOT, "src", "api", "operator.c")
+OUTPUT_H = os.path.join(ROOT, "src", "lexer", "lex-tables.h")
+OUTPUT_C = os.path.join(ROOT, "src", "lexer", "lex-tables.c")
+
+# Punctuation that isn't an operator, and the token type it produces.
+PUNCTUATION = {
+    "::": "YFT_NAMESPACE",
+    ";":  "YFT_SEMICOLON",
+    ",":  "YFT_COMMA",
+    ":":  "YFT_COLON",
+    "(":  "YFT_OPAREN",
+    ")":  "YFT_CPAREN",
+    "{":  "YFT_OBRACE",
+    "}":  "YFT_CBRACE",
+    ".":  "YFT_DOT",
+}
+
+# Keywords, the token type they produce, and their value if they're literals.
+KEYWORDS = {
+    "return": ("YFT_RETURN",  None),
+    "if":     ("YFT_IF",      None),
+    "else":   ("YFT_ELSE",    None),
+    "true":   ("YFT_LITERAL", 1),
+    "false":  ("YFT_LITERAL", 0),
+}
+
+CC_OTHER, CC_SPACE, CC_IDENT, CC_DIGIT, CC_PUNCT, CC_FIRST_OP = range(6)
+
+def read_operators():
+    with open(OPERATOR_C) as f:
+        src = f.read()
+    return re.findall(r'\{\s*"([^"]+)",\s*(YFO_\w+)\s*\}', src)
+
+def build_tokens():
+    tokens = {}
+    for spelling, op in read_operators():
+        tokens[spelling] = ("YFT_OP", op)
+    for spelling, toktype in PUNCTUATION.items():
+        tokens[spelling] = (toktype, "YFO_INVALID")
+    return tokens
+
+def build_dfa(tokens):
+    """
+    A trie over the token spellings - state 0 is "no transition", state 1 is
+    the start state. Returns the alphabet and the list of states, each a
+    (transitions, accept) pair.
+    """
+    alphabet = sorted({c for spelling in tokens for c in spelling})
+    states = [({}, None), ({}, None)]
+    for spelling, accept in sorted(tokens.items()):
+        state = 1
+        for c in spelling:
+            if c not in states[state][0]:
+                states.append(({}, None))
+                states[state][0][c] = len(states) - 1
+            state = states[state][0][c]
+        states[state] = (states[state][0], accept)
+    return alphabet, states
+
+def keyword_hash(word, mult_first, mult_last, mask):
+    """Must match YFL_KW_HASH in lex-tables.h."""
+    return (ord(word[0]) * mult_first + ord(word[-1]) * mult_last
+        + len(word)) & mask
+
+def build_keyword_table():
+    """
+    Find a perfect hash over the keywords - the smallest power-of-two table,
+    and multipliers for the first and last characters, with no collisions.
+    """
+    size = 1
+    while size < len(KEYWORDS):
+        size *= 2
+    while True:
+        for mult_first in range(1, 64):
+            for mult_last in range(0, 64):
+                slots = [None] * size
+                for word in KEYWORDS:
+                    h = keyword_hash(word, mult_first, mult_last, size - 1)
+                    if slots[h] is not None:
+                        break
+                    slots[h] = word
+                else:
+                    return mult_first, mult_last, slots
+        size *= 2
+
+def char_class(c, alphabet):
+    ch = chr(c)
+    if ch in alphabet:
+        return CC_FIRST_OP + alphabet.index(ch)
+    if ch in " \t\n\v\f\r":
+        return CC_SPACE
+    if ch.isascii() and (ch.isalpha() or ch == "_"):
+        return CC_IDENT
+    if ch.isascii() and ch.isdigit():
+        return CC_DIGIT
+    if 33 <= c <= 126:
+        return CC_PUNCT
+    return CC_OTHER
+
+GENERATED_NOTE = [
+    " * Generated by scripts/gen-lexer-tables.py from src/api/operator.c - do",
+    " * not edit by hand.",
+]
+
+def write_header(alphabet, states, keywords):
+
+    out = ["/**", " * Lexer tables."] + GENERATED_NOTE + [" */", ""]
+    out += [
+        "#ifndef LEXER_LEX_TABLES_H",
+        "#define LEXER_LEX_TABLES_H",
+        "",
+        "#include <api/operator.h>",
+        "#include <api/tokens.h>",
+        "",
+        "/**",
+        " * The class of each character. Every character that can start an",
+        " * operator or punctuation token has a class of its own, starting at",
+        " * YFL_CC_FIRST_OP, so that its class doubles as the input to the",
+        " * operator state machine.",
+        " */",
+        "enum yfl_char_class {",
+        "    YFL_CC_OTHER, /* Not valid outside of comments */",
+        "    YFL_CC_SPACE,",
+        "    YFL_CC_IDENT, /* Letters and underscores */",
+        "    YFL_CC_DIGIT,",
+        "    YFL_CC_PUNCT, /* Punctuation that starts no known token */",
+        "    YFL_CC_FIRST_OP,",
+        "};",
+        "",
+        "extern const unsigned char yfl_char_class[256];",
+        "",
+        f"#define YFL_OP_ALPHABET {len(alphabet)}",
+        f"#define YFL_OP_STATES {len(states)}",
+        "",
+        "/**",
+        " * The operator state machine. State 1 is the start state, and a next",
+        " * state of 0 means there is no transition. yfl_op_accept is the token",
+        " * type recognized in a state, or YFT_INVALID if the state is only a",
+        " * prefix of a token. yfl_op_code is the operator recognized, for",
+        " * states that accept a YFT_OP token.",
+        " */",
+        "extern const unsigned char "
+            "yfl_op_next[YFL_OP_STATES][YFL_OP_ALPHABET];",
+        "extern const enum yf_token_type yfl_op_accept[YFL_OP_STATES];",
+        "extern const enum yf_operator yfl_op_code[YFL_OP_STATES];",
+        "",
+        "/**",
+        " * Keywords, in a perfect hash table - every keyword has a slot of its",
+        " * own, so a lookup is one hash, a length check and one compare. The",
+        " * hash only looks at the first and last characters and the length.",
+        " */",
+        "struct yfl_keyword {",
+        "    const char * name; /* NULL for an empty slot */",
+        "    unsigned char len;",
+        "    enum yf_token_type type;",
+        "    enum yf_literal_type lit_type; /* For true and false */",
+        "    int lit_val;",
+        "};",
+        "",
+        f"#define YFL_KW_SLOTS {len(keywords[2])}",
+        f"#define YFL_KW_MIN_LEN {min(map(len, KEYWORDS))}",
+        f"#define YFL_KW_MAX_LEN {max(map(len, KEYWORDS))}",
+        "#define YFL_KW_HASH(str, len) \\",
+        f"    (((unsigned char) (str)[0] * {keywords[0]}u \\",
+        f"        + (unsigned char) (str)[(len) - 1] * {keywords[1]}u \\",
+        "        + (unsigned) (len)) & (YFL_KW_SLOTS - 1))",
+        "",
+        "extern const struct yfl_keyword yfl_keywords[YFL_KW_SLOTS];",
+        "",
+        "#endif /* LEXER_LEX_TABLES_H */",
+        "",
+    ]
+    with open(OUTPUT_H, "w") as f:
+        f.write("\n".join(out))
+
+def write_source(tokens, alphabet, states, keywords):
+
+    out = ["/**"] + GENERATED_NOTE + [" */", ""]
+    out.append('#include "lex-tables.h"')
+    out.append("")
+    out.append("#include <stddef.h> /* NULL */")
+    out.append("")
+    out.append("const unsigned char yfl_char_class[256] = {")
+    for row in range(0, 256, 16):
+        out.append("    " + " ".join(
+            f"{char_class(c, alphabet)}," for c in range(row, row + 16)
+        ))
+    out.append("};")
+    out.append("")
+
+    out.append("/* Operator alphabet, in class order: "
+        + " ".join(alphabet) + " */")
+    out.append("const unsigned char "
+        "yfl_op_next[YFL_OP_STATES][YFL_OP_ALPHABET] = {")
+    for i, (trans, _) in enumerate(states):
+        row = ", ".join(str(trans.get(c, 0)) for c in alphabet)
+        out.append(f"    {{ {row} }}, /* {i} */")
+    out.append("};")
+    out.append("")
+
+    out.append("const enum yf_token_type yfl_op_accept[YFL_OP_STATES] = {")
+    for i, (_, accept) in enumerate(states):
+        spelling = next((s for s, a in tokens.items()
+            if a is accept and accept is not None), None)
+        name = accept[0] if accept else "YFT_INVALID"
+        note = f" /* {spelling} */" if spelling else ""
+        out.append(f"    {name},{note}")
+    out.append("};")
+    out.append("")
+
+    out.append("const enum yf_operator yfl_op_code[YFL_OP_STATES] = {")
+    for i, (_, accept) in enumerate(states):
+        out.append(f"    {accept[1] if accept else 'YFO_INVALID'},")
+    out.append("};")
+    out.append("")
+
+    out.append("const struct yfl_keyword yfl_keywords[YFL_KW_SLOTS] = {")
+    for word in keywords[2]:
+        if word is None:
+            out.append("    { NULL, 0, YFT_INVALID, YFTL_INVALID, 0 },")
+        else:
+            toktype, value = KEYWORDS[word]
+            lit = "YFTL_BOOL" if value is not None else "YFTL_INVALID"
+            out.append(f'    {{ "{word}", {len(word)}, {toktype}, {lit}, '
+                f'{value or 0} }},')
+    out.append("};")
+    out.append("")
+
+    with open(OUTPUT_C, "w") as f:
+        f.write("\n".join(out))
+
+def main():
+    tokens = build_tokens()
+    alphabet, states = build_dfa(tokens)
+    keywords = build_keyword_table()
+    write_header(alphabet, states, keywords)
+    write_source(tokens, alphabet, states, keywords)
+    print(f"{len(states)} states, {len(alphabet)} operator characters, "
+        f"{len(KEYWORDS)} keywords in {len(keywords[2])} slots")
+
+if __name__ == "__main__":
+    main()
@@ -2,7 +2,8 @@
 Test the lexer. This creates two files - one of 25,000 lines and one of 50,000
 lines. Then, it runs the lexer on each of these 10
 times, and uses the time to calculate the time per line, by finding the slope
-of the line."""
+of the line. Tokens are dumped in the binary format, so that the time is spent
+lexing rather than formatting output."""
 
 import os
 import time
@@ -32,14 +33,14 @@ def main():
 
     stime = time.time()
     for i in range(10):
-        os.system("./cmake/yfc temp-file-25k.txt --dump-tokens 1>/dev/null")
+        os.system("./cmake/yfc temp-file-25k.txt --dump-tokens=bin 1>/dev/null")
     etime = time.time()
     time_25k = (etime - stime) / 10
     print("25k: " + str(time_25k))
 
     stime = time.time()
     for i in range(10):
-        os.system("./cmake/yfc temp-file-50k.txt --dump-tokens 1>/dev/null")
+        os.system("./cmake/yfc temp-file-50k.txt --dump-tokens=bin 1>/dev/null")
     etime = time.time()
     time_50k = (etime - stime) / 10
     print("50k: " + str(time_50k))
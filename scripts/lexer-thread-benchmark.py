@@ -0,0 +1,61 @@
+"""
+Compare parsing with and without --lex-thread. This creates files of several
+sizes, parses each of them 5 times both ways, and prints the best time for
+each, as reported by --benchmark. The lexer thread only pays for itself once a
+file is large enough to make up for starting the thread.
+
+Usage (from the repository root, after scripts/build.sh):
+    python3 scripts/lexer-thread-benchmark.py [path to yfc]
+"""
+
+import os
+import re
+import subprocess
+import sys
+
+YFC = sys.argv[1] if len(sys.argv) > 1 else "./cmake/yfc"
+SIZES = [100, 1000, 10000, 50000]
+RUNS = 5
+
+FUNCTION = """f{i}(a: int, b: int): int {{
+    x: int = a + b * {i} - (a - b);
+    x = x + f{prev}(a, b);
+    ~~ comment ~~
+    if (x > 3) {{ return x; }} else {{ return a; }}
+}}
+"""
+
+def write_file(name, functions):
+    with open(name, "w") as f:
+        for i in range(functions):
+            f.write(FUNCTION.format(i=i, prev=max(i - 1, 0)))
+
+def parse_time(name, flags):
+    best = None
+    for _ in range(RUNS):
+        out = subprocess.run(
+            [YFC, "--benchmark", "--just-semantics"] + flags + [name],
+            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True
+        ).stdout
+        match = re.search(r"Time for parsing .*: ([0-9.]+) seconds", out)
+        if not match:
+            sys.exit("no timing in output of " + YFC + ":\n" + out)
+        t = float(match.group(1))
+        best = t if best is None else min(best, t)
+    return best
+
+def main():
+    print(f"{'lines':>10} {'single':>10} {'threaded':>10} {'speedup':>8}")
+    for functions in SIZES:
+        name = f"temp-lex-thread-{functions}.yf"
+        write_file(name, functions)
+        try:
+            single = parse_time(name, [])
+            threaded = parse_time(name, ["--lex-thread"])
+        finally:
+            os.remove(name)
+        print(f"{functions * 6:>10} {single:>10.4f} {threaded:>10.4f} "
+            f"{single / threaded:>7.2f}x")
+
+if __name__ == "__main__":
+    main()
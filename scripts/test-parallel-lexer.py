@@ -0,0 +1,62 @@
+#!/bin/env python3
+
+"""
+Check that lexing with --lex-jobs gives exactly the tokens the ordinary lexer
+does. This makes random files out of pieces of Y-flat - with plenty of
+newlines, comments that span lines, unclosed comments and characters that
+aren't allowed, since those are what the chunks have to agree on - and
+compares the binary token dump, the errors and the exit code of both.
+
+Run by ctest on a few files. By hand (from the repository root, after
+scripts/build.sh):
+    python3 scripts/test-parallel-lexer.py [path to yfc] [number of files]
+"""
+
+import os
+import random
+import subprocess
+import sys
+
+YFC = sys.argv[1] if len(sys.argv) > 1 else "./cmake/yfc"
+FILES = int(sys.argv[2]) if len(sys.argv) > 2 else 300
+JOBS = [2, 3, 4, 7]
+NAME = "temp-parallel-lexer.yf"
+
+PIECES = [
+    " ", "  ", "\t", "\n", "\n", "\n", "\r\n", "    \n   ", " " * 40,
+    "\n" * 20, "~~", "~", "~~~", "~~ comment ~~", "~~ a\n b ~ c\n ~~",
+    "~~" + " \n" * 30 + "~~", "x", "abc", "x1", "_y", "12", "0", "true",
+    "false", "if", "else", "return", "+", "-", "*", "/", "=", "+=", "==",
+    "<=", "&&", "::", ":", ";", ",", ".", "(", ")", "{", "}", "$", "@",
+    "f(a: int, b: int): int {\n    return a + b;\n}\n",
+    "x: int = 3 * (y - 4);\n",
+]
+
+def lex(flags):
+    result = subprocess.run([YFC, "--dump-tokens=bin"] + flags + [NAME],
+        stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+        stdin=subprocess.DEVNULL)
+    return result.returncode, result.stdout, result.stderr
+
+def main():
+    rng = random.Random(0)
+    failed = 0
+    try:
+        for i in range(FILES):
+            src = "".join(rng.choice(PIECES)
+                for _ in range(rng.randint(0, 400)))
+            with open(NAME, "w") as f:
+                f.write(src)
+            expected = lex([])
+            for jobs in JOBS:
+                if lex([f"--lex-jobs={jobs}"]) != expected:
+                    failed += 1
+                    print(f"Mismatch with --lex-jobs={jobs} on:\n{src!r}")
+                    break
+    finally:
+        os.remove(NAME)
+    print(f"{FILES - failed}/{FILES} files lexed the same")
+    sys.exit(1 if failed else 0)
+
+if __name__ == "__main__":
+    main()
@@ -11,7 +11,7 @@
 
 #include <api/operator.h>
 #include <api/sym.h>
-#include <util/list.h>
+#include <util/vector.h>
 
 struct yf_ast_node;
 
@@ -56,7 +56,7 @@ struct yfa_value {
  */
 struct yfa_funccall {
     struct yf_sym * name;
-    struct yf_list args; /* A list of yf_ast_node */
+    struct yf_vector args; /* A list of yf_ast_node */
 };
 
 /**
@@ -79,6 +79,9 @@ struct yfa_expr {
         YFA_BINARY,
         YFA_FUNCCALL,
     } type;
+
+    /* The type the expression evaluates to, filled in during validation. */
+    struct yfs_type * dtype;
     
 };
 
@@ -109,7 +112,7 @@ struct yfa_funcdecl {
     struct yf_sym * name;
     struct yfs_type * ret; /* The return type */
     /* All parameters are stored as vardecls. expr WILL be null for these. */
-    struct yf_list params;
+    struct yf_vector params;
     struct yf_ast_node * body; /* The function body */
     /* The parameter scope */
     struct yfs_symtab * param_scope;
@@ -119,12 +122,12 @@ struct yfa_funcdecl {
  * A program is just a list of top-level declarations.
  */
 struct yfa_program {
-    struct yf_list decls;
+    struct yf_vector decls;
 };
 
 struct yfa_bstmt {
 
-    struct yf_list stmts;
+    struct yf_vector stmts;
 
     /* Each block statement has a scope associated with it - or, its own symbol
      * table. Searches for references start here.
@@ -171,6 +174,4 @@ struct yf_ast_node {
 
 };
 
-void yf_cleanup_ast(struct yf_ast_node * node);
-
 #endif /* API_ABSTRACT_TREE_H */
@@ -9,10 +9,12 @@
 #ifndef API_COMPILATION_DATA_H
 #define API_COMPILATION_DATA_H
 
+#include <stdbool.h>
+
 #include <api/abstract-tree.h>
 #include <api/concrete-tree.h>
 #include <api/sym.h>
-#include <util/list.h>
+#include <util/vector.h>
 #include <util/hashmap.h>
 
 enum yf_compilation_job_type {
@@ -28,6 +30,15 @@ enum yf_compilation_stage {
     YF_COMPILE_CODEGEN,
 };
 
+/**
+ * How tokens are written out for YF_COMPILE_LEXONLY.
+ */
+enum yf_token_format {
+    YF_TOKENS_TEXT, /* Padded columns, for people */
+    YF_TOKENS_BIN,  /* Compact records, see driver/token-dump.h */
+    YF_TOKENS_JSON, /* One JSON object per line */
+};
+
 struct yf_compilation_job {
     enum yf_compilation_job_type type;
 };
@@ -59,6 +70,14 @@ struct yf_compile_analyse_job {
     struct yf_compilation_job job;
 
     enum yf_compilation_stage stage;
+    enum yf_token_format token_format;
+
+    /* Lex on a thread of its own (see yfl_lex_thread), or on lex_jobs threads
+    before parsing (see yfl_lex_all_parallel), and time the lexing and parsing
+    (for --benchmark). */
+    bool lex_thread;
+    int lex_jobs;
+    bool profile;
 
     struct yf_compilation_unit_info * unit_info;
 
@@ -70,6 +89,12 @@ struct yf_compile_analyse_job {
 
     struct yf_ast_node ast_tree;
 
+    /**
+     * Owns everything hanging off of the trees, symbol table and type table.
+     * Destroying the unit is just destroying this.
+     */
+    struct yf_arena arena;
+
 };
 
 /** Compile output file and a symbol file from a compilation unit */
@@ -96,7 +121,7 @@ struct yf_compilation_data {
      * The jobs required to complete the compilation
      * @item_type yf_compilation_job
      */
-    struct yf_list jobs;
+    struct yf_vector jobs;
 
     /** Name of the project, if any (can be NULL) */
     char * project_name;
@@ -111,7 +136,7 @@ struct yf_compilation_data {
      * Holds additional references that will be cleaned
      * @item_type ?
      */
-     struct yf_list garbage;
+     struct yf_vector garbage;
 
 };
 
@@ -23,23 +23,29 @@
 
 #include <api/loc.h>
 #include <api/operator.h>
-#include <util/list.h>
+#include <api/tokens.h>
+#include <util/vector.h>
 
 struct yf_parse_node;
 
-typedef char yfcs_databuf[256];
+/**
+ * All strings in the CST are interned (see util/intern.h), so they can be
+ * compared by pointer and used directly as hashmap keys.
+ */
 
 /**
  * An identifier is like path.to.file::a.b .
  */
 struct yfcs_identifier {
     struct yf_location loc;
-    yfcs_databuf filepath; /* path.to.file */
-    yfcs_databuf name;     /* a.b */
+    const char * filepath; /* path.to.file, or "" if there is no prefix */
+    const char * name;     /* a.b */
 };
 
 struct yfcs_literal {
-    yfcs_databuf value;
+    const char * value; /* The text, for dumps and error messages */
+    enum yf_literal_type type; /* Decoded by the lexer */
+    int val;
 };
 
 /* Any single value, whether an identifier like "a.b" or a literal like 2. */
@@ -60,7 +66,7 @@ struct yfcs_value {
 /* Types are stored as strings in the concrete syntax tree, even future complex
  * types like "class<type> follows constraint". */
 struct yfcs_type {
-    yfcs_databuf databuf;
+    const char * name;
     struct yf_location loc;
 };
 
@@ -69,7 +75,7 @@ struct yfcs_type {
  */
 struct yfcs_funccall {
     struct yfcs_identifier name;
-    struct yf_list args; /* A list of yf_parse_node */
+    struct yf_vector args; /* A list of yf_parse_node */
 };
 
 struct yfcs_expr {
@@ -110,7 +116,7 @@ struct yfcs_funcdecl {
     struct yfcs_identifier name;
     struct yfcs_type ret; /* The return type */
     /* All parameters are stored as parse_node. expr WILL be null for these. */
-    struct yf_list params;
+    struct yf_vector params;
     struct yf_parse_node * body; /* The function body */
 };
 
@@ -121,14 +127,14 @@ struct yfcs_if {
 };
 
 struct yfcs_program {
-    struct yf_list decls;
+    struct yf_vector decls;
 };
 
 /**
  * A block statement.
  */
 struct yfcs_bstmt {
-    struct yf_list stmts;
+    struct yf_vector stmts;
 };
 
 struct yf_parse_node {
@@ -158,6 +164,4 @@ struct yf_parse_node {
 
 };
 
-void yf_cleanup_cst(struct yf_parse_node * node);
-
 #endif /* API_CST_H */
@@ -48,10 +48,10 @@ static void yf_print_line(FILE * out, char * data, ...) {
  */
 void yf_dump_cst(struct yf_parse_node * root, FILE *out) {
 
-    if (root->loc.line && root->loc.column)
+    if (root->loc.file)
         yf_print_line(
             out, "line: %d, colno: %d",
-            root->loc.line, root->loc.column
+            yf_loc_line(root->loc), yf_loc_column(root->loc)
         );
 
     switch (root->type) {
@@ -89,7 +89,7 @@ static void yf_dump_program(struct yfcs_program * node, FILE *out) {
 
     yf_print_line(out, "program");
     indent();
-    YF_LIST_FOREACH(node->decls, child) {
+    YF_VECTOR_FOREACH(node->decls, child) {
         yf_dump_cst(child, out);
     }
     dedent();
@@ -104,7 +104,7 @@ static void yf_dump_vardecl(struct yfcs_vardecl * node, FILE * out) {
     indent();
 
     yf_print_line(out, "name: %s::%s", node->name.filepath, node->name.name);
-    yf_print_line(out, "type: %s", node->type.databuf);
+    yf_print_line(out, "type: %s", node->type.name);
 
     yf_print_line(out, "initialization value:");
     if (node->expr) {
@@ -124,12 +124,12 @@ static void yf_dump_funcdecl(struct yfcs_funcdecl * node, FILE * out) {
     yf_print_line(out, "params");
     indent();
     struct yf_parse_node * param;
-    YF_LIST_FOREACH(node->params, param) {
+    YF_VECTOR_FOREACH(node->params, param) {
         yf_dump_cst(param, out);
     }
     dedent();
     yf_print_line(out, "end params");
-    yf_print_line(out, "return type: %s", node->ret.databuf);
+    yf_print_line(out, "return type: %s", node->ret.name);
     yf_print_line(out, "function body");
     indent();
     yf_dump_cst(node->body, out);
@@ -173,7 +173,7 @@ static void yf_dump_expr(struct yfcs_expr * node, FILE * out) {
         );
         yf_print_line(out, "arguments:");
         indent();
-        YF_LIST_FOREACH(node->call.args, arg) {
+        YF_VECTOR_FOREACH(node->call.args, arg) {
             yf_dump_cst(arg, out);
         }
         dedent();
@@ -190,7 +190,7 @@ static void yf_dump_bstmt(struct yfcs_bstmt * node, FILE * out) {
     struct yf_parse_node * child;
     yf_print_line(out, "block statement");
     indent();
-    YF_LIST_FOREACH(node->stmts, child) {
+    YF_VECTOR_FOREACH(node->stmts, child) {
         yf_dump_cst(child, out);
     }
     dedent();
@@ -3,7 +3,17 @@
  * This may seem overly complex, but it's a convenient wrapper around a file and
  * will also allow others to tap into the lexer and parser without having to
  * shunt their data to a file.
- * 
+ *
+ * The fast path is a buffer holding the whole source (read in one go or
+ * memory-mapped), which the lexer scans directly:
+ * struct yf_lexer_input input {
+ *   .buffer = src,
+ *   .buffer_len = strlen(src),
+ * };
+ *
+ * Otherwise, the lexer pulls the source in through a getc callback. It is read
+ * to the end once, when the lexer is initialized.
+ *
  * Example usage (with a file):
  * struct yf_lexer_input input {
  *   .input = fopen("file.txt", "r"),
@@ -30,6 +40,8 @@
 #ifndef API_LEXER_INPUT_H
 #define API_LEXER_INPUT_H
 
+#include <stddef.h>
+
 struct yf_lexer_input {
 
     /* A pointer to whatever the input structure is. We don't care what it is -
@@ -37,6 +49,13 @@ struct yf_lexer_input {
      */
     void * input;
 
+    /**
+     * If not NULL, the whole source, which must stay valid until lexing is
+     * done. It need not be NUL-terminated. The callbacks are not used then.
+     */
+    const char * buffer;
+    size_t buffer_len;
+
     char * input_name;
     char * identifier_prefix;
 
@@ -47,10 +66,15 @@ struct yf_lexer_input {
 
     /**
      * This function must "unget" the last character of input data. This does
-     * NOT need to hold more than 16 chars.
+     * NOT need to hold more than 16 chars. The lexer itself never calls it -
+     * it's kept so that existing inputs still fit.
      */
     int (*ungetc)(int c, void * input);
 
+    /**
+     * If not NULL, called once the lexer has read all of the input through
+     * getc.
+     */
     int (*close)(void * input);
 
 };
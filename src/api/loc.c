@@ -0,0 +1,118 @@
+#include "loc.h"
+
+#include <util/allocator.h>
+
+struct yf_source {
+    const char * name;
+    uint32_t * line_starts;
+    size_t num_line_starts;
+};
+
+/* Indexed by file ID - entry 0 is unused. */
+static struct {
+    struct yf_source * files;
+    size_t len, cap;
+} sources;
+
+uint32_t yf_add_source(
+    const char * name, uint32_t * line_starts, size_t num_line_starts
+) {
+
+    struct yf_source * newfiles;
+    size_t newcap;
+
+    if (sources.len == sources.cap) {
+        newcap = sources.cap ? sources.cap * 2 : 16;
+        newfiles = yf_realloc(sources.files, sizeof (struct yf_source) * newcap);
+        if (!newfiles)
+            return 0;
+        sources.files = newfiles;
+        sources.cap = newcap;
+        if (sources.len == 0)
+            sources.len = 1;
+    }
+
+    sources.files[sources.len] = (struct yf_source) {
+        .name = name,
+        .line_starts = line_starts,
+        .num_line_starts = num_line_starts,
+    };
+    return sources.len++;
+
+}
+
+/**
+ * The index of the line the location is on, counting from 0 - the number of
+ * lines that start at or before it, found by binary search.
+ */
+static size_t yf_loc_line_index(
+    const struct yf_source * src, uint32_t offset
+) {
+
+    size_t lo = 0, hi = src->num_line_starts, mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (src->line_starts[mid] <= offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+
+}
+
+const char * yf_loc_file(struct yf_location loc) {
+    return loc.file ? sources.files[loc.file].name : "";
+}
+
+int yf_loc_line(struct yf_location loc) {
+    if (!loc.file)
+        return 0;
+    return yf_loc_line_index(&sources.files[loc.file], loc.offset) + 1;
+}
+
+int yf_loc_column(struct yf_location loc) {
+    int line, column;
+    yf_loc_resolve(loc, NULL, &line, &column);
+    return column;
+}
+
+void yf_loc_resolve(
+    struct yf_location loc, size_t * hint, int * line, int * column
+) {
+
+    const struct yf_source * src;
+    size_t l;
+
+    if (!loc.file) {
+        *line = *column = 0;
+        return;
+    }
+    src = &sources.files[loc.file];
+
+    if (hint && (*hint == 0 || src->line_starts[*hint - 1] <= loc.offset)) {
+        for (l = *hint; l < src->num_line_starts
+            && src->line_starts[l] <= loc.offset; ++l) {}
+    } else {
+        l = yf_loc_line_index(src, loc.offset);
+    }
+    if (hint)
+        *hint = l;
+
+    *line = l + 1;
+    *column = loc.offset - (l ? src->line_starts[l - 1] : 0) + 1;
+
+}
+
+void yf_sources_cleanup(void) {
+
+    size_t i;
+
+    for (i = 1; i < sources.len; ++i)
+        yf_free(sources.files[i].line_starts);
+    yf_free(sources.files);
+    sources.files = NULL;
+    sources.len = sources.cap = 0;
+
+}
@@ -5,10 +5,50 @@
 #ifndef API_LOC_H
 #define API_LOC_H
 
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * A location is a source file, by the ID yf_add_source gave it, and a byte
+ * offset into that file. Lines and columns are only worked out when something
+ * is printed, from a table of where each line of the file starts. File 0 is
+ * "nowhere", for nodes that don't come from any one place.
+ */
 struct yf_location {
-    int    line;
-    int    column;
-    char * file;
+    uint32_t file;
+    uint32_t offset;
 };
 
+/**
+ * Register a source file, and return its ID - or 0 if memory allocation
+ * failed. "line_starts" holds the offset of every line but the first, in order,
+ * and is taken over (it must come from yf_malloc). The name is not copied.
+ */
+uint32_t yf_add_source(
+    const char * name, uint32_t * line_starts, size_t num_line_starts
+);
+
+/**
+ * The file name, line and column of a location. Lines and columns start at 1;
+ * the line and column of "nowhere" are 0.
+ */
+const char * yf_loc_file(struct yf_location loc);
+int yf_loc_line(struct yf_location loc);
+int yf_loc_column(struct yf_location loc);
+
+/**
+ * The line and column of a location at once. If "hint" is not NULL, it holds
+ * the line index found by the last call (start it at 0), and a location on the
+ * same line or a later one is found by stepping forward from there instead of
+ * searching - which is what walking a file's tokens in order needs.
+ */
+void yf_loc_resolve(
+    struct yf_location loc, size_t * hint, int * line, int * column
+);
+
+/**
+ * Free all registered sources.
+ */
+void yf_sources_cleanup(void);
+
 #endif /* API_LOC_H */
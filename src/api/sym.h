@@ -10,7 +10,6 @@
 #define API_SYM_H
 
 #include <api/loc.h>
-#include <util/list.h>
 #include <util/hashmap.h>
 
 /**
@@ -39,36 +38,30 @@ struct yfs_type {
         YFST_PRIMITIVE,
     } kind;
 
-    char * name; /* Name of the type */
+    const char * name; /* Name of the type (interned) */
 
-};
+    /* A small, dense number identifying the type - builtin types come first,
+    see semantics/types.h. */
+    int id;
 
-/**
- * Free up a type.
- */
-int yfs_cleanup_type(struct yfs_type * type);
+};
 
 struct yfs_var {
 
-    char * name;
+    const char * name;
     struct yfs_type * dtype; /* "declared type" */    
 
 };
 
-/**
- * This is a parameter for a function. The reason this isn't a vardecl is that
- * a symbol table needs variable types, but when a symbol table is being built
- * the types that exist are not yet known.
- */
-struct yfsn_param {
-    char * name, * type;
-};
-
 struct yfs_fn {
 
-    char * name;
+    const char * name;
     struct yfs_type * rtype; /* "return type" */
-    struct yf_list    params; /* list of param */
+
+    /* The parameter types, resolved when the symbol table is built. An entry
+    is NULL if its type could not be found. */
+    struct yfs_type ** params;
+    size_t arity;
 
 };
 
@@ -88,8 +81,6 @@ struct yf_sym {
 
 };
 
-int yfs_cleanup_sym(struct yf_sym * sym);
-
 struct yfs_symtab {
 
     struct yf_hashmap * table;
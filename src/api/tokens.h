@@ -6,6 +6,7 @@
 #define API_TOKENS_H
 
 #include <api/loc.h>
+#include <api/operator.h>
 
 enum yf_token_type {
 
@@ -29,10 +30,18 @@ enum yf_token_type {
     YFT_ELSE,
     YFT_NAMESPACE, /* :: */
     YFT_DOT,
-    YFT_TOO_LARGE, /* A token was too large */
 
 };
 
+/**
+ * The kind of value a literal token holds.
+ */
+enum yf_literal_type {
+    YFTL_INVALID, /* A malformed number, like 12ab */
+    YFTL_INT,
+    YFTL_BOOL,
+};
+
 /**
  * TODO - have source file name
  */
@@ -40,8 +49,22 @@ struct yf_token {
 
     enum yf_token_type type;
 
-    /* Maybe increase this later, for long strings? */
-    char data [ 256 ];
+    /* The text of the token. This points into the source the lexer is
+    scanning, so it is NOT NUL-terminated, and is only valid as long as that
+    source is. Print it with "%.*s". */
+    const char * text;
+    int len;
+
+    /* The interned copy of the text, for identifiers and literals. NULL for all
+    other token types. Use this for anything that outlives the source. */
+    const char * istr;
+
+    /* For YFT_OP tokens, the operator - YFO_INVALID if it isn't one. */
+    enum yf_operator op;
+
+    /* For YFT_LITERAL tokens, the decoded value. */
+    enum yf_literal_type lit_type;
+    int lit_val;
 
     struct yf_location loc;
 
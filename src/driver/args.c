@@ -149,12 +149,25 @@ void yf_parse_args(int argc, char ** argv, struct yf_args * args) {
             continue;
         }
 
-        if (STREQ(arg, "--dump-tokens")) {
+        if (STREQ(arg, "--dump-tokens")
+            || !strncmp(arg, "--dump-tokens=", 14)) {
             if (args->cstdump || args->just_semantics) {
                 yf_set_error(args);
                 return;
             }
             args->tdump = 1;
+            if (arg[13] == '=') {
+                if (STREQ(arg + 14, "text")) {
+                    args->tdump_format = YF_TOKENS_TEXT;
+                } else if (STREQ(arg + 14, "bin")) {
+                    args->tdump_format = YF_TOKENS_BIN;
+                } else if (STREQ(arg + 14, "json")) {
+                    args->tdump_format = YF_TOKENS_JSON;
+                } else {
+                    yf_set_error(args);
+                    return;
+                }
+            }
             continue;
         }
 
@@ -176,6 +189,31 @@ void yf_parse_args(int argc, char ** argv, struct yf_args * args) {
             continue;
         }
 
+        if (STREQ(arg, "--lex-thread")) {
+            if (args->lex_jobs) {
+                yf_set_error(args);
+                return;
+            }
+            args->lex_thread = 1;
+            continue;
+        }
+
+        if (!strncmp(arg, "--lex-jobs=", 11)) {
+            char * end;
+            long jobs;
+            if (args->lex_thread) {
+                yf_set_error(args);
+                return;
+            }
+            jobs = strtol(arg + 11, &end, 10);
+            if (end == arg + 11 || *end || jobs < 1 || jobs > 64) {
+                yf_set_error(args);
+                return;
+            }
+            args->lex_jobs = jobs;
+            continue;
+        }
+
         if (STREQ(arg, "--benchmark")) {
             if (args->profile || args->wanted_output != YF_NONE) {
                 yf_set_error(args);
@@ -185,6 +223,22 @@ void yf_parse_args(int argc, char ** argv, struct yf_args * args) {
             continue;
         }
 
+        if (STREQ(arg, "--profile") || !strncmp(arg, "--profile=", 10)) {
+            if (args->mem_profile) {
+                yf_set_error(args);
+                return;
+            }
+            args->mem_profile = 1;
+            if (arg[9] == '=') {
+                if (!arg[10]) {
+                    yf_set_error(args);
+                    return;
+                }
+                args->profile_output = arg + 10;
+            }
+            continue;
+        }
+
         if (STREQ(arg, "--dump-projfiles")) {
             args->dump_projfiles = 1;
             args->project = 1;
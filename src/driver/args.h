@@ -7,6 +7,8 @@
 
 #include <stdbool.h>
 
+#include <api/compilation-data.h>
+
 /**
  * Any of the possible outputs wanted.
  */
@@ -63,15 +65,27 @@ struct yf_args {
     bool project;
 
     /**
-     * Are we just dumping tokens for each file?
+     * Are we just dumping tokens for each file? And in what format?
      */
     bool tdump;
+    enum yf_token_format tdump_format;
 
     /**
      * How about ... just dumping the CST?
      */
     bool cstdump;
 
+    /**
+     * Should each file be lexed on a thread of its own, while it's parsed?
+     */
+    bool lex_thread;
+
+    /**
+     * How many threads to lex each file with, all at once before parsing. 0 if
+     * not given, which is the same as 1.
+     */
+    int lex_jobs;
+
     /**
      * What about ... not trying to generate any code?
      */
@@ -82,6 +96,13 @@ struct yf_args {
      */
     bool profile;
 
+    /**
+     * Should we report how much memory each part of the compiler used? The
+     * report goes to stderr, or as JSON to profile_output if it isn't NULL.
+     */
+    bool mem_profile;
+    const char * profile_output;
+
     /**
      * Should we be dumping out all the files in a project?
      */
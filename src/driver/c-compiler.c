@@ -9,6 +9,8 @@
 #include <string.h> /* strlen, strcpy */
 #include <unistd.h>
 
+#include <util/allocator.h>
+
 /**
  * Internal - determine whether a compiler exists on this machine.
  * This runs the command and sees if a non-existence error happens.
@@ -45,13 +47,13 @@ static int compiler_exists(const char * compiler, const char ** selected) {
 
     size_t buf_size = 255;
     size_t buf_idx = 0;
-    char * buf = malloc(255);
+    char * buf = yf_malloc(255);
 
     ssize_t read_sz = 0;
     while ((read_sz = read(commfp[0], buf + buf_idx, buf_size - buf_idx)) > 0) {
         buf_idx += read_sz;
         if (buf_size - buf_idx < 10)
-            buf = realloc(buf, buf_size *= 2);
+            buf = yf_realloc(buf, buf_size *= 2);
     }
 
     if (read_sz < 0)
@@ -69,7 +71,7 @@ static int compiler_exists(const char * compiler, const char ** selected) {
         buf[buf_idx - 1] = 0;
         *selected = buf;
     } else {
-        free(buf);
+        yf_free(buf);
     }
 
     close(commfp[0]);
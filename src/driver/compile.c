@@ -10,13 +10,19 @@
 #include <api/compilation-data.h>
 #include <api/cst-dump.h>
 #include <api/lexer-input.h>
+#include <api/loc.h>
 #include <driver/compiler-backend.h>
 #include <driver/find-files.h>
+#include <driver/os.h>
+#include <driver/profile.h>
+#include <driver/token-dump.h>
 #include <parser/parser.h>
 #include <semantics/symtab.h>
+#include <semantics/types.h>
 #include <semantics/validate/validate.h>
 #include <util/allocator.h>
-#include <util/list.h>
+#include <util/intern.h>
+#include <util/vector.h>
 #include <util/yfc-out.h>
 
 /* Forward decls for whole file */
@@ -31,7 +37,6 @@ static int yfc_validate_compile(
     struct yf_compile_compile_job *
 );
 static int yf_find_project_files(struct yf_project_compilation_data *);
-static int dump_tokens(struct yf_lexer *);
 static int yf_build_symtab(struct yf_compile_analyse_job *);
 static int yf_validate_ast(
     struct yf_compilation_data * pdata,
@@ -98,8 +103,14 @@ int yf_run_compiler(struct yf_args * args) {
     if (res)
         return res;
 
+    if (yfs_init_types()) {
+        YF_PRINT_ERROR("Could not set up builtin types");
+        yf_cleanup(&compilation);
+        return 1;
+    }
+
     /* Execute jobs */
-    YF_LIST_FOREACH(compilation.jobs, job) {
+    YF_VECTOR_FOREACH(compilation.jobs, job) {
         switch (job->type) {
             case YF_COMPILATION_ANALYSE:
                 if (args->dump_commands) {
@@ -136,6 +147,13 @@ int yf_run_compiler(struct yf_args * args) {
 
     yf_cleanup(&compilation);
     yf_free((void *)args->selected_compiler);
+    yfs_cleanup_types();
+    yf_intern_cleanup();
+    yf_sources_cleanup();
+
+    /* Everything has been freed by now, so anything still live is a leak. */
+    if (args->mem_profile && yf_report_memory_profile(args->profile_output))
+        res = 1;
 
     return res;
 
@@ -147,7 +165,7 @@ static int yf_create_compiler_jobs(
     struct yf_args * args
 ) {
 
-    int i;
+    struct yfh_entry * entry;
     struct yf_compilation_unit_info * fdata;
     struct yf_compile_analyse_job * ujob;
     struct yf_compile_compile_job * cjob;
@@ -155,48 +173,52 @@ static int yf_create_compiler_jobs(
 
     yf_backend_find_compiler(args);
 
-    struct yf_list link_objs;
-    yf_list_init(&link_objs);
+    struct yf_vector link_objs;
+    yf_vector_init(&link_objs);
 
     /* Fill project info */
     compilation->project_name = data->project_name;
-    yf_list_init(&compilation->jobs);
-    compilation->symtables = yfh_new();
-    yf_list_init(&compilation->garbage);
+    yf_vector_init(&compilation->jobs);
+    compilation->symtables = yfh_new_sized(data->files->num_entries);
+    yf_vector_init(&compilation->garbage);
 
-    for (i = 0; i < YFH_BUCKETS; ++i) {
-        fdata = data->files->buckets[i].value;
-        if (!fdata) continue;
+    YFH_FOREACH(data->files, entry) {
+        fdata = entry->value;
 
-        ujob = malloc(sizeof(struct yf_compile_analyse_job));
+        ujob = yf_malloc(sizeof(struct yf_compile_analyse_job));
         memset(ujob, 0, sizeof(struct yf_compile_analyse_job));
 
         ujob->job.type = YF_COMPILATION_ANALYSE;
         ujob->unit_info = fdata;
+        yf_arena_init(&ujob->arena);
 
         ujob->stage =
             args->tdump          ? YF_COMPILE_LEXONLY     :
             args->cstdump        ? YF_COMPILE_PARSEONLY   :
             args->just_semantics ? YF_COMPILE_ANALYSEONLY :
                 YF_COMPILE_CODEGEN;
+        ujob->token_format = args->tdump_format;
+        ujob->lex_thread = args->lex_thread;
+        ujob->lex_jobs = args->lex_jobs;
+        ujob->profile = args->profile;
 
-        data->files->buckets[i].value = ujob; // Set the job for further stages
-        yf_list_add(&compilation->jobs, ujob);
+        entry->value = ujob; // Set the job for further stages
+        yf_vector_push(&compilation->jobs, ujob);
     }
 
-    for (i = 0; i < YFH_BUCKETS; ++i) {
-        ujob = data->files->buckets[i].value;
-        if (!ujob || ujob->stage < YF_COMPILE_ANALYSEONLY)
+    YFH_FOREACH(data->files, entry) {
+        ujob = entry->value;
+        if (ujob->stage < YF_COMPILE_ANALYSEONLY)
             continue;
 
-        cjob = malloc(sizeof(struct yf_compile_compile_job));
+        cjob = yf_malloc(sizeof(struct yf_compile_compile_job));
         cjob->job.type = YF_COMPILATION_COMPILE;
         cjob->unit = ujob;
-        yf_list_add(&compilation->jobs, cjob);
+        yf_vector_push(&compilation->jobs, cjob);
 
         if (ujob->stage >= YF_COMPILE_CODEGEN) {
             char * object_file = yf_backend_add_compile_job(compilation, args, ujob->unit_info);
-            yf_list_add(&link_objs, object_file);
+            yf_vector_push(&link_objs, object_file);
             has_compiled_files = true;
         }
     }
@@ -205,7 +227,7 @@ static int yf_create_compiler_jobs(
         yf_backend_add_link_job(compilation, args, &link_objs);
     }
 
-    yf_list_merge(&compilation->garbage, &link_objs);
+    yf_vector_merge(&compilation->garbage, &link_objs);
     yfh_destroy(data->files, NULL);
 
     return 0;
@@ -235,7 +257,8 @@ static int yf_run_compiler_on_data(
     } \
 } while (0)
 
-    int i, err = 0;
+    int err = 0;
+    struct yfh_entry * entry;
     struct yf_file_compilation_data * fdata;
 
     /* For profiling purposes only */
@@ -245,9 +268,8 @@ static int yf_run_compiler_on_data(
     /* Parse the frontend for all and create symtabs */
     BEGIN_PROFILE();
     total_begin = step_begin;
-    for (i = 0; i < YFH_BUCKETS; ++i) {
-        fdata = data->files->buckets[i].value;
-        if (!fdata) continue;
+    YFH_FOREACH(data->files, entry) {
+        fdata = entry->value;
         fdata->error = 0; /* Starting off clean */
         if (yf_run_frontend(fdata, args)) {
             fdata->error = 1;
@@ -259,9 +281,8 @@ static int yf_run_compiler_on_data(
     END_PROFILE("parsing");
 
     BEGIN_PROFILE();
-    for (i = 0; i < YFH_BUCKETS; ++i) {
-        fdata = data->files->buckets[i].value;
-        if (!fdata) continue;
+    YFH_FOREACH(data->files, entry) {
+        fdata = entry->value;
         if (!fdata->error) {
             if (yf_build_symtab(fdata)) {
                 fdata->error = 1;
@@ -277,9 +298,8 @@ static int yf_run_compiler_on_data(
 
     /* Now validate everything. */
     BEGIN_PROFILE();
-    for (i = 0; i < YFH_BUCKETS; ++i) {
-        fdata = data->files->buckets[i].value;
-        if (!fdata) continue;
+    YFH_FOREACH(data->files, entry) {
+        fdata = entry->value;
         if (!fdata->error
             && yf_validate_ast(
                 data, fdata, args
@@ -320,7 +340,7 @@ static int yf_compile_project(struct yf_args * args, struct yf_compilation_data
 
     struct yf_project_compilation_data data;
     struct yf_compilation_unit_info * fdata;
-    int i;
+    struct yfh_entry * entry;
 
     /**
      * Project name is current directory
@@ -338,9 +358,8 @@ static int yf_compile_project(struct yf_args * args, struct yf_compilation_data
 
     if (args->dump_projfiles) {
         YF_PRINT_DEFAULT("Project files: (green = needs to be recompiled):");    
-        for (i = 0; i < YFH_BUCKETS; ++i) {
-            fdata = data.files->buckets[i].value;
-            if (!fdata) continue;
+        YFH_FOREACH(data.files, entry) {
+            fdata = entry->value;
             if (fdata->parse_anew) {
                 YF_PRINT_WITH_COLOR(
                     YF_CODE_YELLOW,
@@ -373,15 +392,15 @@ static int yf_compile_files(struct yf_args * args, struct yf_compilation_data *
     /* No project name */
     data.project_name = NULL;
 
-    data.files = yfh_new();
+    data.files = yfh_new_sized(args->num_files);
 
     for (i = 0; i < args->num_files; ++i) {
-        fdata = malloc(sizeof(struct yf_compilation_unit_info));
+        fdata = yf_malloc(sizeof(struct yf_compilation_unit_info));
         memset(fdata, 0, sizeof (struct yf_compilation_unit_info));
         fdata->file_name = yf_strdup(args->files[i]);
         fdata->parse_anew = 1;
         /* TODO - more data */
-        yfh_set(data.files, fdata->file_name, fdata);
+        yfh_set(data.files, yf_intern(fdata->file_name), fdata);
     }
 
     return yf_create_compiler_jobs(compilation, &data, args);
@@ -406,8 +425,11 @@ static int yfc_validate_compile(
         return 1;
     }
 
-    if (adata->stage >= YF_COMPILE_CODEGEN)
+    if (adata->stage >= YF_COMPILE_CODEGEN) {
+        yf_set_alloc_tag(YF_ALLOC_GEN);
         retval = yf_backend_generate_code(adata);
+        yf_set_alloc_tag(YF_ALLOC_DRIVER);
+    }
 
     return retval;
 
@@ -423,52 +445,90 @@ static int yfc_run_frontend_build_symtable(
 
     struct yf_lexer_input input;
     struct yf_lexer lexer;
-    FILE * file_src;
+    mapped_file file_src;
     char * file_name;
     struct stat file_stat;
     struct yf_compilation_unit_info * file = data->unit_info;
+    struct timeval parse_begin, parse_end;
 
     int retval;
 
     file_name = file->parse_anew ? file->file_name : file->sym_file;
-    file_src = fopen(
-        file_name,
-        "r"
-    );
-    if (!file_src) {
+    if (stat(file_name, &file_stat)) {
         YF_PRINT_ERROR("Could not open file %s", file_name);
         return 1;
     }
-    stat(file_name, &file_stat);
     if (!S_ISREG(file_stat.st_mode)) {
         YF_PRINT_ERROR("%s is not a regular file", file_name);
         return 1;
     }
+    /* The lexer scans the whole source in place. */
+    if (file_map(&file_src, file_name)) {
+        YF_PRINT_ERROR("Could not open file %s", file_name);
+        return 1;
+    }
     
     input = (struct yf_lexer_input) {
-        .input = file_src,
-        .getc = (int (*)(void*)) getc,
-        .ungetc = (int (*)(int, void*)) ungetc,
+        .buffer = file_src.data,
+        .buffer_len = file_src.size,
         .input_name = file_name,
-        .close = (int (*) (void*))fclose,
         .identifier_prefix = file->file_prefix ? file->file_prefix : "" /** TODO: Let user chose file prefix */
     };
 
-    yfl_init(&lexer, &input);
+    if (yfl_init(&lexer, &input)) {
+        YF_PRINT_ERROR("Could not read file %s", file_name);
+        file_unmap(&file_src);
+        return 1;
+    }
+
+    gettimeofday(&parse_begin, NULL);
+    if (data->lex_thread && yfl_lex_thread(&lexer)) {
+        YF_PRINT_ERROR("Could not start lexer thread for %s", file_name);
+        yfl_cleanup(&lexer);
+        file_unmap(&file_src);
+        return 1;
+    }
+    if (data->lex_jobs > 1 && yfl_lex_all_parallel(&lexer, data->lex_jobs)) {
+        YF_PRINT_ERROR("Could not lex file %s", file_name);
+        yfl_cleanup(&lexer);
+        file_unmap(&file_src);
+        return 1;
+    }
 
     if (data->stage == YF_COMPILE_LEXONLY) {
-        return dump_tokens(&lexer);
+        yf_set_alloc_tag(YF_ALLOC_LEXER);
+        retval = yf_dump_tokens(&lexer, data->token_format, stdout);
+        yf_set_alloc_tag(YF_ALLOC_DRIVER);
+        yfl_cleanup(&lexer);
+        file_unmap(&file_src);
+        return retval;
     } else {
-        if ( (retval = yf_parse(&lexer, &data->parse_tree)) ) {
+        yf_set_alloc_tag(YF_ALLOC_PARSER);
+        retval = yf_parse(&lexer, &data->parse_tree, &data->arena);
+        yf_set_alloc_tag(YF_ALLOC_DRIVER);
+        /* Nothing in the parse tree points into the source. */
+        yfl_cleanup(&lexer);
+        gettimeofday(&parse_end, NULL);
+        if (data->profile) {
+            YF_PRINT_DEFAULT(
+                "Time for parsing %s: %f seconds", file_name,
+                (parse_end.tv_sec - parse_begin.tv_sec)
+                    + (parse_end.tv_usec - parse_begin.tv_usec) / 1000000.0
+            );
+        }
+        file_unmap(&file_src);
+        if (retval) {
             YF_PRINT_ERROR("Error parsing file %s", file->file_name);
             return retval;
         }
         if (data->stage == YF_COMPILE_PARSEONLY) {
             retval = yf_do_cst_dump(&data->parse_tree);
         } else {
+            yf_set_alloc_tag(YF_ALLOC_SYMTAB);
             retval = yf_build_symtab(data);
+            yf_set_alloc_tag(YF_ALLOC_DRIVER);
             if (!retval && data->unit_info->file_prefix)
-                yfh_set(compilation->symtables, data->unit_info->file_prefix, &data->symtab);
+                yfh_set(compilation->symtables, yf_intern(data->unit_info->file_prefix), &data->symtab);
         }
         return retval;
     }
@@ -483,33 +543,6 @@ static int yf_find_project_files(struct yf_project_compilation_data * data) {
     return yfd_find_projfiles(data);
 }
 
-/**
- * Dump all file tokens.
- */
-static int dump_tokens(struct yf_lexer * lexer) {
-
-    struct yf_token token;
-    for (;;) {
-        if (yfl_lex(lexer, &token)) {
-            YF_PRINT_ERROR("Invalid token");
-            return 1;
-        }
-        if (token.type == YFT_EOF) {
-            break;
-        }
-        printf(
-            "%20s, line: %3d, col: %3d, type: %20s\n",
-            token.data,
-            token.loc.line, token.loc.column, 
-            yf_get_toktype(token.type)
-        );
-    }
-
-    return 0; /* Indicates that nothing should else should be done (meaning no
-    semantic analysis, etc. */
-
-}
-
 /**
  * Dump the CST.
  */
@@ -534,7 +567,12 @@ static int yf_validate_ast(
     struct yf_compile_analyse_job * adata
 ) {
 
-    return yfs_validate(adata, pdata);
+    int retval;
+
+    yf_set_alloc_tag(YF_ALLOC_VALIDATE);
+    retval = yfs_validate(adata, pdata);
+    yf_set_alloc_tag(YF_ALLOC_DRIVER);
+    return retval;
 
 }
 
@@ -545,21 +583,14 @@ static int yf_cleanup(struct yf_compilation_data * data) {
 
     struct yf_compilation_job * job;
 
-    YF_LIST_FOREACH(data->jobs, job) {
+    YF_VECTOR_FOREACH(data->jobs, job) {
         switch (job->type) {
             case YF_COMPILATION_ANALYSE: {
                 struct yf_compile_analyse_job * adata = (struct yf_compile_analyse_job *)job;
                 struct yf_compilation_unit_info * fdata = adata->unit_info;
 
-                if (adata->types.table)
-                    yfh_destroy(adata->types.table, (int (*)(void *)) yfs_cleanup_type);
-
-                if (adata->symtab.table)
-                    yfh_destroy(adata->symtab.table, (int (*)(void *)) yfs_cleanup_sym);
-
-                // Will be EMPTY if unset
-                yf_cleanup_cst(&adata->parse_tree);
-                yf_cleanup_ast(&adata->ast_tree);
+                /* Trees, symbols and types all live in the arena. */
+                yf_arena_destroy(&adata->arena);
 
                 yf_free(fdata->file_name);
                 yf_free(fdata->file_prefix);
@@ -579,9 +610,9 @@ static int yf_cleanup(struct yf_compilation_data * data) {
     }
 
     yf_free(data->project_name);
-    yf_list_destroy(&data->jobs, true);
+    yf_vector_destroy(&data->jobs, true);
     yfh_destroy(data->symtables, NULL);
-    yf_list_destroy(&data->garbage, true);
+    yf_vector_destroy(&data->garbage, true);
 
     return 0;
 
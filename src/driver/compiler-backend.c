@@ -8,7 +8,8 @@
 #include <driver/os.h>
 #include <gen/gen.h>
 #include <util/allocator.h>
-#include <util/list.h>
+#include <util/intern.h>
+#include <util/vector.h>
 #include <util/yfc-out.h>
 
 static void dump_command(const char * const cmd[]) {
@@ -161,11 +162,11 @@ char * yf_backend_add_compile_job(
     memcpy(object_file, unit->output_file, fname_len + 1);
     object_file[fname_len - 1] = 'o';
 
-    cjob = malloc(sizeof(struct yf_compile_exec_job));
+    cjob = yf_malloc(sizeof(struct yf_compile_exec_job));
     cjob->job.type = YF_COMPILATION_EXEC;
 
     /* Where gcc -c foo.c -o foo.o is stored */
-    cjob->command = malloc(sizeof(const char *) * 6);
+    cjob->command = yf_malloc(sizeof(const char *) * 6);
     cjob->command[0] = args->selected_compiler;
     cjob->command[1] = "-c";
     cjob->command[2] = unit->output_file;
@@ -173,7 +174,7 @@ char * yf_backend_add_compile_job(
     cjob->command[4] = object_file;
     cjob->command[5] = NULL;
 
-    yf_list_add(&compilation->jobs, cjob);
+    yf_vector_push(&compilation->jobs, cjob);
 
     return object_file;
 
@@ -182,7 +183,7 @@ char * yf_backend_add_compile_job(
 int yf_backend_add_link_job(
     struct yf_compilation_data * compilation,
     struct yf_args * args,
-    struct yf_list * link_objs
+    struct yf_vector * link_objs
 ) {
     /* Where gcc foo1.o foo2.o -o foo is stored */
     const char ** link_cmd;
@@ -191,24 +192,17 @@ int yf_backend_add_link_job(
     size_t num_objs;
     const char * object_file;
 
-    size_t obj_it;
     const char ** it;
 
-    num_objs = 0;
-    YF_LIST_FOREACH(*link_objs, object_file) {
-        ++num_objs;
-    }
+    num_objs = link_objs->len;
 
     /* <compiler> <objects...> -o <executable> */
     link_cmd = yf_malloc((4 + num_objs) * sizeof(const char *));
     link_cmd[0] = args->selected_compiler;
 
     it = link_cmd + 1;
-    yf_list_reset(link_objs);
-    for (obj_it = 0; obj_it < num_objs; ++obj_it) {
-        yf_list_get(link_objs, (void **)it);
-        yf_list_next(link_objs);
-        ++it;
+    YF_VECTOR_FOREACH(*link_objs, object_file) {
+        *it++ = object_file;
     }
 
     /* Finally, add -o output_file */
@@ -226,7 +220,7 @@ int yf_backend_add_link_job(
     ljob->job.type = YF_COMPILATION_EXEC;
     ljob->command = link_cmd;
 
-    yf_list_add(&compilation->jobs, ljob);
+    yf_vector_push(&compilation->jobs, ljob);
 
     return 0;
 
@@ -264,17 +258,16 @@ int yf_ensure_entry_point(
 ) {
 
     /* Iteration data */
+    struct yfh_entry * entry;
     struct yfs_symtab * fsymtab;
-    int i, total_entries = 0;
+    int total_entries = 0;
 
-    for (i = 0; i < YFH_BUCKETS; ++i) {
+    YFH_FOREACH(pdata->symtables, entry) {
 
-        /* Iteration boilerplate */
-        fsymtab = pdata->symtables->buckets[i].value;
-        if (!fsymtab) continue;
+        fsymtab = entry->value;
 
         /* If a lookup for "main" succeeds, that's another entry point. */
-        if (yfh_get(fsymtab->table, "main")) {
+        if (yfh_get(fsymtab->table, yf_intern("main"))) {
             ++total_entries;
         }
 
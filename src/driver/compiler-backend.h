@@ -30,7 +30,7 @@ char * yf_backend_add_compile_job(
 int yf_backend_add_link_job(
     struct yf_compilation_data *,
     struct yf_args *,
-    struct yf_list * object_list
+    struct yf_vector * object_list
 );
 
 int yf_backend_generate_code(
@@ -10,10 +10,16 @@ const char
       "yfc <file1> <file2> ...: compile and link the given files, up to 16.\n"
       "--project: Compile all files in src/ that need to be compiled. "
       "Read documentation for more specifics on this flag.\n"
-      "--dump-tokens: Test lexer by printing out all tokens.\n"
+      "--dump-tokens[=text|bin|json]: Test lexer by printing out all tokens, "
+      "as text (the default), binary records or one JSON object per line.\n"
       "--dump-cst: Test parser by printing out the CST.\n"
       "--just-semantics: Only verify the code, do not generate it.\n"
+      "--lex-thread: Lex each file on a separate thread while it is parsed.\n"
+      "--lex-jobs=<n>: Split each file into <n> chunks and lex them at the "
+      "same time, before parsing.\n"
       "--benchmark: Print out time taken for each step.\n"
+      "--profile[=<file>]: Report memory used by each part of the compiler, "
+      "to stderr or as JSON to <file>.\n"
       "--dump-projfiles: Print out all files in a project.\n"
       "--dump-commands: Show all compiler invocations.\n"
       "--simulate-run: Like --dump-commands, show all compiler invocations, but don't actually execute any of them.\n"
@@ -1,5 +1,6 @@
 #include "os.h"
 
+#include <util/allocator.h>
 #include <util/platform.h>
 
 #include <stdio.h>
@@ -92,6 +93,44 @@ int proc_wait(process_handle * proc) {
     proc->exit_code = WEXITSTATUS(status);
     return 0;
 }
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+int file_map(mapped_file * file, const char * path) {
+    struct stat st;
+    void * data;
+    int fd = open(path, O_RDONLY);
+    if (fd == -1)
+        return -1;
+    if (fstat(fd, &st) == -1) {
+        close(fd);
+        return -1;
+    }
+    file->size = st.st_size;
+    file->handle = NULL;
+    if (file->size == 0) {
+        // mmap refuses empty mappings
+        file->data = "";
+        close(fd);
+        return 0;
+    }
+    data = mmap(NULL, file->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return -1;
+    madvise(data, file->size, MADV_SEQUENTIAL);
+    file->data = data;
+    file->handle = data;
+    return 0;
+}
+
+void file_unmap(mapped_file * file) {
+    if (file->handle)
+        munmap(file->handle, file->size);
+    file->data = NULL;
+    file->handle = NULL;
+}
 #elif defined(YF_PLATFORM_WINNT)
 #include <Windows.h>
 
@@ -218,6 +257,36 @@ int proc_wait(process_handle * proc) {
 
     return 0;
 }
+
+// Sources are small enough that reading them in one go is as good as mapping.
+int file_map(mapped_file * file, const char * path) {
+    char * data;
+    long size;
+    FILE * fp = fopen(path, "rb");
+    if (!fp)
+        return -1;
+    if (fseek(fp, 0, SEEK_END) || (size = ftell(fp)) < 0 || fseek(fp, 0, SEEK_SET)) {
+        fclose(fp);
+        return -1;
+    }
+    data = yf_malloc(size + 1);
+    if (!data || fread(data, 1, size, fp) != (size_t) size) {
+        yf_free(data);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+    file->data = data;
+    file->size = size;
+    file->handle = data;
+    return 0;
+}
+
+void file_unmap(mapped_file * file) {
+    yf_free(file->handle);
+    file->data = NULL;
+    file->handle = NULL;
+}
 #else /* YF_PLATFORM_UNIX | YF_PLATFORM_WINNT */
 #error Unknown platform
 #endif
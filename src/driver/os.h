@@ -8,6 +8,7 @@
 
 #define YF_OS_USE_PATH (1 << 0)
 
+#include <stddef.h>
 #include <stdint.h>
 
 typedef struct {
@@ -40,4 +41,22 @@ int proc_open(process_handle * proc, const char * const argv[], const file_open_
  */
 int proc_wait(process_handle * proc);
 
+typedef struct {
+    const char * data; // NOT NUL-terminated
+    size_t size;
+    void * handle; // platform-specific, only for file_unmap
+} mapped_file;
+
+/**
+ * Make the whole contents of a file available as one read-only buffer, mapping
+ * it into memory where the platform allows it.
+ * @return 0 on success, otherwise nonzero
+ */
+int file_map(mapped_file * file, const char * path);
+
+/**
+ * Release a buffer from file_map.
+ */
+void file_unmap(mapped_file * file);
+
 #endif /* DRIVER_OS_H */
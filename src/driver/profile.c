@@ -0,0 +1,89 @@
+#include "profile.h"
+
+#include <stdio.h>
+#include <sys/resource.h>
+
+#include <util/allocator.h>
+#include <util/yfc-out.h>
+
+/**
+ * Peak resident set size in kilobytes, or -1 if unknown.
+ */
+static long yf_peak_rss_kb(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage))
+        return -1;
+    return usage.ru_maxrss;
+}
+
+static void yf_print_memory_profile(FILE * out) {
+
+    int tag;
+    struct yf_alloc_stats st;
+    struct yf_pool_stats pool;
+
+    fprintf(out, "Memory profile:\n");
+    fprintf(out, "  %-15s %12s %14s %14s %14s\n",
+        "part", "allocs", "bytes", "peak bytes", "live bytes");
+    for (tag = 0; tag <= YF_ALLOC_NUM_TAGS; ++tag) {
+        yf_get_alloc_stats(tag, &st);
+        fprintf(out, "  %-15s %12zu %14zu %14zu %14zu\n",
+            yf_alloc_tag_name(tag), st.allocs, st.bytes, st.peak, st.live);
+    }
+    fprintf(out, "  (arena allocations are carved out of the arena overhead's "
+        "chunks, and only the chunks count toward the total)\n");
+    yf_get_pool_stats(&pool);
+    fprintf(out, "  arena blocks freed: %zu, reused: %zu\n",
+        pool.freed, pool.reused);
+    fprintf(out, "  peak RSS: %ld KB\n", yf_peak_rss_kb());
+
+}
+
+static void yf_write_stats_json(FILE * out, struct yf_alloc_stats * st) {
+    fprintf(out,
+        "{\"allocs\": %zu, \"bytes\": %zu, \"peak\": %zu, \"live\": %zu}",
+        st->allocs, st->bytes, st->peak, st->live);
+}
+
+static void yf_write_memory_profile_json(FILE * out) {
+
+    int tag;
+    struct yf_alloc_stats st;
+    struct yf_pool_stats pool;
+
+    fprintf(out, "{\n  \"tags\": {\n");
+    for (tag = 0; tag < YF_ALLOC_NUM_TAGS; ++tag) {
+        yf_get_alloc_stats(tag, &st);
+        fprintf(out, "    \"%s\": ", yf_alloc_tag_name(tag));
+        yf_write_stats_json(out, &st);
+        fprintf(out, "%s\n", tag + 1 < YF_ALLOC_NUM_TAGS ? "," : "");
+    }
+    fprintf(out, "  },\n  \"total\": ");
+    yf_get_alloc_stats(YF_ALLOC_NUM_TAGS, &st);
+    yf_write_stats_json(out, &st);
+    yf_get_pool_stats(&pool);
+    fprintf(out, ",\n  \"arena_pool\": {\"freed\": %zu, \"reused\": %zu}",
+        pool.freed, pool.reused);
+    fprintf(out, ",\n  \"peak_rss_kb\": %ld\n}\n", yf_peak_rss_kb());
+
+}
+
+int yf_report_memory_profile(const char * json_file) {
+
+    FILE * out;
+
+    if (!json_file) {
+        yf_print_memory_profile(stderr);
+        return 0;
+    }
+
+    out = fopen(json_file, "w");
+    if (!out) {
+        YF_PRINT_ERROR("Could not open profile output %s", json_file);
+        return 1;
+    }
+    yf_write_memory_profile_json(out);
+    fclose(out);
+    return 0;
+
+}
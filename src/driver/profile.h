@@ -0,0 +1,16 @@
+/**
+ * Reporting of resource usage, for --profile.
+ */
+
+#ifndef DRIVER_PROFILE_H
+#define DRIVER_PROFILE_H
+
+/**
+ * Report the allocation statistics of each part of the compiler, along with the
+ * peak resident set size of the process. If json_file is NULL, a table is
+ * printed to stderr, otherwise JSON is written to that file.
+ * Return 0 on success, 1 if the file could not be written.
+ */
+int yf_report_memory_profile(const char * json_file);
+
+#endif /* DRIVER_PROFILE_H */
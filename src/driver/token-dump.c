@@ -0,0 +1,226 @@
+#include "token-dump.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <api/loc.h>
+#include <util/yfc-out.h>
+
+/**
+ * Output goes through one large buffer, and numbers are formatted by hand -
+ * dumping a big file is millions of tokens, and printf would be most of the
+ * time spent.
+ */
+struct yfd_out {
+    FILE * file;
+    size_t len;
+    int error;
+    char buf[1 << 16];
+};
+
+static void yfd_flush(struct yfd_out * out) {
+    if (out->len && fwrite(out->buf, 1, out->len, out->file) != out->len)
+        out->error = 1;
+    out->len = 0;
+}
+
+/**
+ * Make room for n bytes. Return 0 if they don't fit even in an empty buffer.
+ */
+static inline int yfd_reserve(struct yfd_out * out, size_t n) {
+    if (sizeof out->buf - out->len < n)
+        yfd_flush(out);
+    return n <= sizeof out->buf;
+}
+
+static void yfd_put(struct yfd_out * out, const char * str, size_t n) {
+    if (!yfd_reserve(out, n)) {
+        if (fwrite(str, 1, n, out->file) != n)
+            out->error = 1;
+        return;
+    }
+    memcpy(out->buf + out->len, str, n);
+    out->len += n;
+}
+
+static inline void yfd_putc(struct yfd_out * out, char c) {
+    yfd_reserve(out, 1);
+    out->buf[out->len++] = c;
+}
+
+/**
+ * Write n bytes of str, right-aligned in a field of "width".
+ */
+static void yfd_put_padded(
+    struct yfd_out * out, const char * str, size_t n, size_t width
+) {
+    size_t pad = n < width ? width - n : 0;
+    yfd_reserve(out, pad);
+    memset(out->buf + out->len, ' ', pad);
+    out->len += pad;
+    yfd_put(out, str, n);
+}
+
+/**
+ * Write a number, right-aligned in a field of "width" (0 for none).
+ */
+static void yfd_put_int(struct yfd_out * out, long val, size_t width) {
+
+    char digits[24];
+    char * p = digits + sizeof digits;
+    unsigned long u = val < 0 ? -(unsigned long) val : (unsigned long) val;
+
+    do {
+        *--p = '0' + u % 10;
+        u /= 10;
+    } while (u);
+    if (val < 0)
+        *--p = '-';
+
+    yfd_put_padded(out, p, digits + sizeof digits - p, width);
+
+}
+
+static void yfd_put_u32(struct yfd_out * out, uint32_t val) {
+    yfd_reserve(out, 4);
+    out->buf[out->len++] = val & 0xFF;
+    out->buf[out->len++] = (val >> 8) & 0xFF;
+    out->buf[out->len++] = (val >> 16) & 0xFF;
+    out->buf[out->len++] = (val >> 24) & 0xFF;
+}
+
+/**
+ * Write a string for a JSON document, with quotes.
+ */
+static void yfd_put_json_str(struct yfd_out * out, const char * str, size_t n) {
+
+    static const char hex[] = "0123456789abcdef";
+    const char * p, * run;
+    unsigned char c;
+
+    yfd_putc(out, '"');
+    for (run = p = str; p != str + n; ++p) {
+        c = *p;
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        yfd_put(out, run, p - run);
+        run = p + 1;
+        if (c == '"' || c == '\\') {
+            yfd_putc(out, '\\');
+            yfd_putc(out, c);
+        } else {
+            yfd_put(out, "\\u00", 4);
+            yfd_putc(out, hex[c >> 4]);
+            yfd_putc(out, hex[c & 0xF]);
+        }
+    }
+    yfd_put(out, run, p - run);
+    yfd_putc(out, '"');
+
+}
+
+#define YFD_PUT_LIT(out, lit) yfd_put(out, lit, sizeof lit - 1)
+
+/**
+ * The format of old - what "%20.*s, line: %3d, col: %3d, type: %20s\n" gave.
+ */
+static void yfd_dump_text(
+    struct yfd_out * out, const struct yf_token * token, int line, int col
+) {
+    const char * type = yf_get_toktype(token->type);
+    yfd_put_padded(out, token->text, token->len, 20);
+    YFD_PUT_LIT(out, ", line: ");
+    yfd_put_int(out, line, 3);
+    YFD_PUT_LIT(out, ", col: ");
+    yfd_put_int(out, col, 3);
+    YFD_PUT_LIT(out, ", type: ");
+    yfd_put_padded(out, type, strlen(type), 20);
+    yfd_putc(out, '\n');
+}
+
+static void yfd_dump_json(
+    struct yfd_out * out, const struct yf_token * token, int line, int col
+) {
+    const char * type = yf_get_toktype(token->type);
+    YFD_PUT_LIT(out, "{\"type\":");
+    yfd_put_json_str(out, type, strlen(type));
+    YFD_PUT_LIT(out, ",\"text\":");
+    yfd_put_json_str(out, token->text, token->len);
+    YFD_PUT_LIT(out, ",\"line\":");
+    yfd_put_int(out, line, 0);
+    YFD_PUT_LIT(out, ",\"col\":");
+    yfd_put_int(out, col, 0);
+    YFD_PUT_LIT(out, ",\"offset\":");
+    yfd_put_int(out, token->loc.offset, 0);
+    YFD_PUT_LIT(out, "}\n");
+}
+
+static void yfd_dump_bin(
+    struct yfd_out * out, const struct yf_token * token, int line, int col
+) {
+    /* The end of file has no text in the source. */
+    size_t len = token->type == YFT_EOF ? 0 : token->len;
+    yfd_reserve(out, 2);
+    out->buf[out->len++] = token->type;
+    out->buf[out->len++] = token->op;
+    yfd_put_u32(out, line);
+    yfd_put_u32(out, col);
+    yfd_put_u32(out, token->loc.offset);
+    yfd_put_u32(out, len);
+    yfd_put(out, token->text, len);
+}
+
+int yf_dump_tokens(
+    struct yf_lexer * lexer, enum yf_token_format format, FILE * file
+) {
+
+    struct yfd_out out;
+    struct yf_token token;
+    const char * name = lexer->input->input_name;
+    size_t hint = 0;
+    int line, col, ret = 0;
+
+    out.file = file;
+    out.len = 0;
+    out.error = 0;
+
+    if (format == YF_TOKENS_BIN) {
+        YFD_PUT_LIT(&out, YF_TOKENS_BIN_MAGIC);
+        yfd_putc(&out, YF_TOKENS_BIN_VERSION);
+        yfd_put_u32(&out, strlen(name));
+        yfd_put(&out, name, strlen(name));
+    }
+
+    for (;;) {
+        if (yfl_lex(lexer, &token)) {
+            yfd_flush(&out);
+            YF_PRINT_ERROR("Invalid token");
+            return 1;
+        }
+        /* Only the binary format marks the end of a file. */
+        if (token.type == YFT_EOF && format != YF_TOKENS_BIN)
+            break;
+        yf_loc_resolve(token.loc, &hint, &line, &col);
+        switch (format) {
+        case YF_TOKENS_TEXT:
+            yfd_dump_text(&out, &token, line, col);
+            break;
+        case YF_TOKENS_JSON:
+            yfd_dump_json(&out, &token, line, col);
+            break;
+        case YF_TOKENS_BIN:
+            yfd_dump_bin(&out, &token, line, col);
+            break;
+        }
+        if (token.type == YFT_EOF)
+            break;
+    }
+
+    yfd_flush(&out);
+    if (fflush(file) || out.error) {
+        YF_PRINT_ERROR("Could not write tokens of %s", name);
+        ret = 1;
+    }
+    return ret;
+
+}
@@ -0,0 +1,32 @@
+/**
+ * Writing out the tokens of a file, for --dump-tokens.
+ */
+
+#ifndef DRIVER_TOKEN_DUMP_H
+#define DRIVER_TOKEN_DUMP_H
+
+#include <stdio.h>
+
+#include <api/compilation-data.h>
+#include <lexer/lexer.h>
+
+/**
+ * The binary format starts every file with a header:
+ *  "YFTK", a version byte (1), a u32 name length and the file name.
+ * Then one record per token, ending with the end-of-file token:
+ *  u8 type (enum yf_token_type), u8 operator (enum yf_operator), u32 line,
+ *  u32 column, u32 byte offset, u32 length and the token's text.
+ * All integers are little-endian.
+ */
+#define YF_TOKENS_BIN_MAGIC "YFTK"
+#define YF_TOKENS_BIN_VERSION 1
+
+/**
+ * Lex the rest of the file, and write its tokens to "out" in the given format.
+ * Return 0 on success, 1 if there was a lexing error or writing failed.
+ */
+int yf_dump_tokens(
+    struct yf_lexer * lexer, enum yf_token_format format, FILE * out
+);
+
+#endif /* DRIVER_TOKEN_DUMP_H */
@@ -67,7 +67,7 @@ static void yf_gen_program(
 
     struct yf_ast_node * child;
 
-    YF_LIST_FOREACH(node->decls, child) {
+    YF_VECTOR_FOREACH(node->decls, child) {
         yf_gen_node(child, out, i);
         if (child->type == YFA_VARDECL)
             yfg_print_line(out, ";", i);
@@ -113,7 +113,7 @@ static void yf_gen_funcdecl(
 
     /* Generate param list */
 
-    YF_LIST_FOREACH(node->params, child) {
+    YF_VECTOR_FOREACH(node->params, child) {
         if (argct)
             fprintf(out, ", ");
         if (!child) break;
@@ -163,7 +163,7 @@ static void yf_gen_expr(
                 i->gen_prefix, node->as.call.name->fn.name
             );
             argct = 0;
-            YF_LIST_FOREACH(node->as.call.args, call_arg) {
+            YF_VECTOR_FOREACH(node->as.call.args, call_arg) {
                 if (argct)
                     fprintf(out, ", ");
                 if (!call_arg) break;
@@ -183,7 +183,7 @@ static void yf_gen_bstmt(
     struct yf_ast_node * child;
     fprintf(out, "{");
     indent(i);
-    YF_LIST_FOREACH(node->stmts, child) {
+    YF_VECTOR_FOREACH(node->stmts, child) {
         yfg_print_line(out, "", i);
         yf_gen_node(child, out, i);
         fprintf(out, ";");
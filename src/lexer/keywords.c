@@ -1,30 +1,21 @@
 #include "keywords.h"
 
-#include <stdlib.h> /* NULL */
 #include <string.h>
 
-struct keyword_lookup {
-    char * name;
-    enum yf_token_type value;
-} keywords[] = {
-    { "return", YFT_RETURN },
-    { "if", YFT_IF },
-    { "else", YFT_ELSE },
-    { "true", YFT_LITERAL },
-    { "false", YFT_LITERAL },
-    { NULL, YFT_EOF },
-};
+/**
+ * The keyword table is generated, see scripts/gen-lexer-tables.py.
+ */
+const struct yfl_keyword * yf_find_keyword(const char * str, size_t len) {
 
-enum yf_token_type yf_keyword_type(char * str) {
+    const struct yfl_keyword * k;
 
-    struct keyword_lookup * k;
+    if (len < YFL_KW_MIN_LEN || len > YFL_KW_MAX_LEN)
+        return NULL;
 
-    for (k = keywords; k->name; k++) {
-        if (strcmp(k->name, str) == 0) {
-            return k->value;
-        }
-    }
+    k = &yfl_keywords[YFL_KW_HASH(str, len)];
+    if (k->len == len && memcmp(k->name, str, len) == 0)
+        return k;
 
-    return YFT_INVALID;
+    return NULL;
 
 }
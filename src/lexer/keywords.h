@@ -5,11 +5,14 @@
 #ifndef LEXER_KEYWORDS_H
 #define LEXER_KEYWORDS_H
 
-#include <api/tokens.h>
+#include <stddef.h>
+
+#include <lexer/lex-tables.h>
 
 /**
- * Get the keyword type efrom a keyword, or YFT_INVALID if it is not a keyword.
+ * Find the keyword spelled by the first "len" characters of str, or NULL if
+ * they are not a keyword. str need not be NUL-terminated.
  */
-enum yf_token_type yf_keyword_type(char * str);
+const struct yfl_keyword * yf_find_keyword(const char * str, size_t len);
 
 #endif /* LEXER_KEYWORDS_H */
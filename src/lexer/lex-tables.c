@@ -0,0 +1,153 @@
+/**
+ * Generated by scripts/gen-lexer-tables.py from src/api/operator.c - do
+ * not edit by hand.
+ */
+
+#include "lex-tables.h"
+
+#include <stddef.h> /* NULL */
+
+const unsigned char yfl_char_class[256] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 5, 4, 4, 4, 6, 7, 4, 8, 9, 10, 11, 12, 13, 14, 15,
+    3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 16, 17, 18, 19, 20, 4,
+    4, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 4, 4, 4, 21, 2,
+    4, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+    2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 22, 23, 24, 4, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+/* Operator alphabet, in class order: ! % & ( ) * + , - . / : ; < = > ^ { | } */
+const unsigned char yfl_op_next[YFL_OP_STATES][YFL_OP_ALPHABET] = {
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 0 */
+    { 2, 4, 6, 8, 9, 10, 12, 14, 15, 17, 18, 20, 22, 23, 25, 27, 29, 31, 32, 34 }, /* 1 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0 }, /* 2 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 3 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 5, 0, 0, 0, 0, 0 }, /* 4 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 5 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 7, 0, 0, 0, 0, 0 }, /* 6 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 7 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 8 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 9 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 11, 0, 0, 0, 0, 0 }, /* 10 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 11 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 13, 0, 0, 0, 0, 0 }, /* 12 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 13 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 14 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16, 0, 0, 0, 0, 0 }, /* 15 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 16 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 17 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 19, 0, 0, 0, 0, 0 }, /* 18 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 19 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 21, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 20 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 21 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 22 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 24, 0, 0, 0, 0, 0 }, /* 23 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 24 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 26, 0, 0, 0, 0, 0 }, /* 25 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 26 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 28, 0, 0, 0, 0, 0 }, /* 27 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 28 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 30, 0, 0, 0, 0, 0 }, /* 29 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 30 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 31 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 33, 0, 0, 0, 0, 0 }, /* 32 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 33 */
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, /* 34 */
+};
+
+const enum yf_token_type yfl_op_accept[YFL_OP_STATES] = {
+    YFT_INVALID,
+    YFT_INVALID,
+    YFT_INVALID,
+    YFT_OP, /* != */
+    YFT_OP, /* % */
+    YFT_OP, /* %= */
+    YFT_OP, /* & */
+    YFT_OP, /* &= */
+    YFT_OPAREN, /* ( */
+    YFT_CPAREN, /* ) */
+    YFT_OP, /* * */
+    YFT_OP, /* *= */
+    YFT_OP, /* + */
+    YFT_OP, /* += */
+    YFT_COMMA, /* , */
+    YFT_OP, /* - */
+    YFT_OP, /* -= */
+    YFT_DOT, /* . */
+    YFT_OP, /* / */
+    YFT_OP, /* /= */
+    YFT_COLON, /* : */
+    YFT_NAMESPACE, /* :: */
+    YFT_SEMICOLON, /* ; */
+    YFT_OP, /* < */
+    YFT_OP, /* <= */
+    YFT_OP, /* = */
+    YFT_OP, /* == */
+    YFT_OP, /* > */
+    YFT_OP, /* >= */
+    YFT_OP, /* ^ */
+    YFT_OP, /* ^= */
+    YFT_OBRACE, /* { */
+    YFT_OP, /* | */
+    YFT_OP, /* |= */
+    YFT_CBRACE, /* } */
+};
+
+const enum yf_operator yfl_op_code[YFL_OP_STATES] = {
+    YFO_INVALID,
+    YFO_INVALID,
+    YFO_INVALID,
+    YFO_NEQ,
+    YFO_MOD,
+    YFO_AMOD,
+    YFO_AND,
+    YFO_AAND,
+    YFO_INVALID,
+    YFO_INVALID,
+    YFO_MUL,
+    YFO_AMUL,
+    YFO_ADD,
+    YFO_AADD,
+    YFO_INVALID,
+    YFO_SUB,
+    YFO_ASUB,
+    YFO_INVALID,
+    YFO_DIV,
+    YFO_ADIV,
+    YFO_INVALID,
+    YFO_INVALID,
+    YFO_INVALID,
+    YFO_LT,
+    YFO_LTE,
+    YFO_ASSIGN,
+    YFO_EQ,
+    YFO_GT,
+    YFO_GTE,
+    YFO_XOR,
+    YFO_AXOR,
+    YFO_INVALID,
+    YFO_OR,
+    YFO_AOR,
+    YFO_INVALID,
+};
+
+const struct yfl_keyword yfl_keywords[YFL_KW_SLOTS] = {
+    { NULL, 0, YFT_INVALID, YFTL_INVALID, 0 },
+    { NULL, 0, YFT_INVALID, YFTL_INVALID, 0 },
+    { "true", 4, YFT_LITERAL, YFTL_BOOL, 1 },
+    { "else", 4, YFT_ELSE, YFTL_INVALID, 0 },
+    { "return", 6, YFT_RETURN, YFTL_INVALID, 0 },
+    { "false", 5, YFT_LITERAL, YFTL_BOOL, 0 },
+    { NULL, 0, YFT_INVALID, YFTL_INVALID, 0 },
+    { "if", 2, YFT_IF, YFTL_INVALID, 0 },
+};
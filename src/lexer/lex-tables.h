@@ -0,0 +1,67 @@
+/**
+ * Lexer tables.
+ * Generated by scripts/gen-lexer-tables.py from src/api/operator.c - do
+ * not edit by hand.
+ */
+
+#ifndef LEXER_LEX_TABLES_H
+#define LEXER_LEX_TABLES_H
+
+#include <api/operator.h>
+#include <api/tokens.h>
+
+/**
+ * The class of each character. Every character that can start an
+ * operator or punctuation token has a class of its own, starting at
+ * YFL_CC_FIRST_OP, so that its class doubles as the input to the
+ * operator state machine.
+ */
+enum yfl_char_class {
+    YFL_CC_OTHER, /* Not valid outside of comments */
+    YFL_CC_SPACE,
+    YFL_CC_IDENT, /* Letters and underscores */
+    YFL_CC_DIGIT,
+    YFL_CC_PUNCT, /* Punctuation that starts no known token */
+    YFL_CC_FIRST_OP,
+};
+
+extern const unsigned char yfl_char_class[256];
+
+#define YFL_OP_ALPHABET 20
+#define YFL_OP_STATES 35
+
+/**
+ * The operator state machine. State 1 is the start state, and a next
+ * state of 0 means there is no transition. yfl_op_accept is the token
+ * type recognized in a state, or YFT_INVALID if the state is only a
+ * prefix of a token. yfl_op_code is the operator recognized, for
+ * states that accept a YFT_OP token.
+ */
+extern const unsigned char yfl_op_next[YFL_OP_STATES][YFL_OP_ALPHABET];
+extern const enum yf_token_type yfl_op_accept[YFL_OP_STATES];
+extern const enum yf_operator yfl_op_code[YFL_OP_STATES];
+
+/**
+ * Keywords, in a perfect hash table - every keyword has a slot of its
+ * own, so a lookup is one hash, a length check and one compare. The
+ * hash only looks at the first and last characters and the length.
+ */
+struct yfl_keyword {
+    const char * name; /* NULL for an empty slot */
+    unsigned char len;
+    enum yf_token_type type;
+    enum yf_literal_type lit_type; /* For true and false */
+    int lit_val;
+};
+
+#define YFL_KW_SLOTS 8
+#define YFL_KW_MIN_LEN 2
+#define YFL_KW_MAX_LEN 6
+#define YFL_KW_HASH(str, len) \
+    (((unsigned char) (str)[0] * 1u \
+        + (unsigned char) (str)[(len) - 1] * 2u \
+        + (unsigned) (len)) & (YFL_KW_SLOTS - 1))
+
+extern const struct yfl_keyword yfl_keywords[YFL_KW_SLOTS];
+
+#endif /* LEXER_LEX_TABLES_H */
@@ -0,0 +1,54 @@
+/**
+ * Parts of lexer.c shared with the rest of the lexer module.
+ */
+
+#ifndef LEXER_LEXER_INTERNAL_H
+#define LEXER_LEXER_INTERNAL_H
+
+#include <lexer/lexer.h>
+
+/**
+ * Lex the next token from the unlexed buffer or the source, whatever mode the
+ * lexer is in.
+ */
+enum yfl_code yfl_lex_next(struct yf_lexer * lexer, struct yf_token * token);
+
+/**
+ * Lex from the lexer's position to the end of its source (or the first error)
+ * into "s", which must be empty. Return 1 if allocating the stream failed.
+ */
+int yfl_lex_into(struct yf_lexer * lexer, struct yf_token_stream * s);
+
+/**
+ * Grow every array of the token stream to hold "cap" tokens. Return 1 if
+ * memory allocation failed.
+ */
+int yfl_stream_reserve(struct yf_token_stream * s, size_t cap);
+
+/**
+ * Store a token at index i, which must be below the stream's capacity.
+ */
+void yfl_stream_store(
+    struct yf_token_stream * s, size_t i, const struct yf_token * token
+);
+
+/**
+ * Add the first "count" tokens of src to the end of dst, which must have room
+ * for them.
+ */
+void yfl_stream_append(
+    struct yf_token_stream * dst, const struct yf_token_stream * src,
+    size_t count
+);
+
+void yfl_stream_free(struct yf_token_stream * s);
+
+/**
+ * An unclosed comment leaves no token - this is what goes in the stream in its
+ * place, an end of file at the end of the lexer's source.
+ */
+void yfl_open_comment_token(
+    const struct yf_lexer * lexer, struct yf_token * token
+);
+
+#endif /* LEXER_LEXER_INTERNAL_H */
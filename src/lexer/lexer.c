@@ -1,10 +1,15 @@
 #include "lexer.h"
 
-#include <ctype.h>
 #include <stdio.h>
 #include <string.h>
 
 #include <lexer/keywords.h>
+#include <lexer/lex-tables.h>
+#include <lexer/lexer-internal.h>
+#include <lexer/ring.h>
+#include <lexer/scan.h>
+#include <util/allocator.h>
+#include <util/intern.h>
 #include <util/yfc-out.h>
 
 /**
@@ -15,7 +20,7 @@ char * get_error_message(int error_code) {
         "Okay",
         "Unknown Error",
         "Open comment",
-        "Overflow",
+        "Too many tokens after a mark for the lexer thread to keep",
     };
 
 	return yfl_code_message[error_code];
@@ -23,23 +28,259 @@ char * get_error_message(int error_code) {
 
 /* Forward decls */
 static enum yfl_code yfl_core_lex(struct yf_lexer *, struct yf_token *);
-static int yfl_getc(struct yf_lexer * lexer);
-static int yfl_ungetc(struct yf_lexer * lexer, int c);
+static int yfl_read_input(struct yf_lexer * lexer);
+static int yfl_add_source(struct yf_lexer * lexer);
 static int yfl_skip_whitespace(struct yf_lexer * lexer);
 static int yfl_skip_comment(struct yf_lexer * lexer);
 static int yfl_skip_all(struct yf_lexer * lexer);
 
-void yfl_init(
+int yfl_init(
     struct yf_lexer * lexer,
     struct yf_lexer_input * input
 ) {
     
-    lexer->loc.line = 1; /* Line count starts at 1 */
-    lexer->loc.column = 1;  /* Same with column */
-    lexer->loc.file = input->input_name;
-
     lexer->input = input;
     lexer->unlex_ct = 0;
+    lexer->owned_buf = NULL;
+    memset(&lexer->stream, 0, sizeof lexer->stream);
+    lexer->pos = 0;
+    lexer->marks = 0;
+    lexer->ring = NULL;
+    lexer->interns = NULL;
+
+    if (input->buffer) {
+        lexer->cur = input->buffer;
+        lexer->end = input->buffer + input->buffer_len;
+    } else if (yfl_read_input(lexer)) {
+        return 1;
+    }
+    lexer->base = lexer->cur;
+
+    if (yfl_add_source(lexer)) {
+        yfl_cleanup(lexer);
+        return 1;
+    }
+    return 0;
+
+}
+
+/**
+ * Find the lines of the source, and register it.
+ */
+static int yfl_add_source(struct yf_lexer * lexer) {
+
+    size_t len = lexer->end - lexer->base, num_lines;
+    uint32_t * starts;
+    enum yf_alloc_tag prev_tag;
+
+    /* Offsets are 32 bits. */
+    if (len > UINT32_MAX)
+        return 1;
+
+    prev_tag = yf_set_alloc_tag(YF_ALLOC_LEXER);
+    num_lines = yfl_scan_line_starts(lexer->base, len, NULL);
+    starts = yf_malloc(sizeof (uint32_t) * (num_lines + 1));
+    yf_set_alloc_tag(prev_tag);
+    if (!starts)
+        return 1;
+    yfl_scan_line_starts(lexer->base, len, starts);
+
+    if ( (lexer->file = yf_add_source(
+        lexer->input->input_name, starts, num_lines)) == 0) {
+        yf_free(starts);
+        return 1;
+    }
+    return 0;
+
+}
+
+void yfl_cleanup(struct yf_lexer * lexer) {
+    if (lexer->ring)
+        yfl_ring_stop(lexer);
+    yfl_stream_free(&lexer->stream);
+    yf_free(lexer->owned_buf);
+    lexer->owned_buf = NULL;
+    lexer->base = lexer->cur = lexer->end = NULL;
+}
+
+/**
+ * Read a callback input to its end, so that it can be scanned like a buffer.
+ */
+static int yfl_read_input(struct yf_lexer * lexer) {
+
+    struct yf_lexer_input * input = lexer->input;
+    size_t len = 0, cap = 4096;
+    char * buf, * newbuf;
+    int c;
+
+    if ( (buf = yf_malloc(cap)) == NULL)
+        return 1;
+
+    while ( (c = input->getc(input->input)) != EOF) {
+        if (len == cap) {
+            cap *= 2;
+            if ( (newbuf = yf_realloc(buf, cap)) == NULL) {
+                yf_free(buf);
+                return 1;
+            }
+            buf = newbuf;
+        }
+        buf[len++] = c;
+    }
+
+    if (input->close)
+        input->close(input->input);
+
+    lexer->owned_buf = buf;
+    lexer->cur = buf;
+    lexer->end = buf + len;
+    return 0;
+
+}
+
+int yfl_stream_reserve(struct yf_token_stream * s, size_t cap) {
+
+    void * p;
+
+#define YFL_GROW(field) do { \
+    if ( (p = yf_realloc(s->field, cap * sizeof *s->field)) == NULL) \
+        return 1; \
+    s->field = p; \
+} while (0)
+
+    YFL_GROW(types);
+    YFL_GROW(ops);
+    YFL_GROW(lit_types);
+    YFL_GROW(lit_vals);
+    YFL_GROW(offsets);
+    YFL_GROW(lens);
+    YFL_GROW(istrs);
+
+#undef YFL_GROW
+
+    s->cap = cap;
+    return 0;
+
+}
+
+void yfl_stream_store(
+    struct yf_token_stream * s, size_t i, const struct yf_token * token
+) {
+    s->types[i] = token->type;
+    s->ops[i] = token->op;
+    s->lit_types[i] = token->lit_type;
+    s->lit_vals[i] = token->lit_val;
+    s->offsets[i] = token->loc.offset;
+    s->lens[i] = token->len;
+    s->istrs[i] = token->istr;
+}
+
+static void yfl_stream_load(
+    const struct yf_lexer * lexer, size_t i, struct yf_token * token
+) {
+    const struct yf_token_stream * s = &lexer->stream;
+    token->type = s->types[i];
+    token->op = s->ops[i];
+    token->lit_type = s->lit_types[i];
+    token->lit_val = s->lit_vals[i];
+    if (token->type == YFT_EOF) {
+        token->text = "[EOF]";
+        token->len = 5;
+    } else {
+        token->text = lexer->base + s->offsets[i];
+        token->len = s->lens[i];
+    }
+    token->istr = s->istrs[i];
+    token->loc.file = lexer->file;
+    token->loc.offset = s->offsets[i];
+}
+
+void yfl_open_comment_token(
+    const struct yf_lexer * lexer, struct yf_token * token
+) {
+    token->type = YFT_EOF;
+    token->op = YFO_INVALID;
+    token->lit_type = YFTL_INVALID;
+    token->lit_val = 0;
+    token->text = lexer->end;
+    token->len = 0;
+    token->istr = NULL;
+    token->loc.file = lexer->file;
+    token->loc.offset = lexer->end - lexer->base;
+}
+
+void yfl_stream_append(
+    struct yf_token_stream * dst, const struct yf_token_stream * src,
+    size_t count
+) {
+
+#define YFL_APPEND(field) memcpy( \
+    dst->field + dst->len, src->field, count * sizeof *src->field)
+
+    YFL_APPEND(types);
+    YFL_APPEND(ops);
+    YFL_APPEND(lit_types);
+    YFL_APPEND(lit_vals);
+    YFL_APPEND(offsets);
+    YFL_APPEND(lens);
+    YFL_APPEND(istrs);
+
+#undef YFL_APPEND
+
+    dst->len += count;
+
+}
+
+void yfl_stream_free(struct yf_token_stream * s) {
+    yf_free(s->types);
+    yf_free(s->ops);
+    yf_free(s->lit_types);
+    yf_free(s->lit_vals);
+    yf_free(s->offsets);
+    yf_free(s->lens);
+    yf_free(s->istrs);
+    memset(s, 0, sizeof *s);
+}
+
+int yfl_lex_into(struct yf_lexer * lexer, struct yf_token_stream * s) {
+
+    struct yf_token token;
+    enum yfl_code code;
+
+    /* Start with room for a token every four characters, which is about what
+    real code has, so that most units never grow. */
+    if (yfl_stream_reserve(s, (lexer->end - lexer->cur) / 4 + 16))
+        return 1;
+
+    for (;;) {
+        if (s->len == s->cap && yfl_stream_reserve(s, s->cap * 2))
+            return 1;
+        code = yfl_lex_next(lexer, &token);
+        if (code == YFLC_OPEN_COMMENT)
+            yfl_open_comment_token(lexer, &token);
+        yfl_stream_store(s, s->len++, &token);
+        if (code != YFLC_OK) {
+            s->err = code;
+            break;
+        }
+        if (token.type == YFT_EOF)
+            break;
+    }
+
+    return 0;
+
+}
+
+int yfl_lex_all(struct yf_lexer * lexer) {
+
+    enum yf_alloc_tag prev_tag;
+    int ret;
+
+    prev_tag = yf_set_alloc_tag(YF_ALLOC_LEXER);
+    ret = yfl_lex_into(lexer, &lexer->stream);
+    yf_set_alloc_tag(prev_tag);
+    lexer->pos = 0;
+    return ret;
 
 }
 
@@ -47,7 +288,28 @@ void yfl_init(
  * Stuff a token with data.
  */
 enum yfl_code yfl_lex(struct yf_lexer * lexer, struct yf_token * token) {
-    
+
+    size_t i;
+
+    if (lexer->stream.types) {
+        /* Reading past the end keeps returning the last token, EOF. Those
+        reads still move "pos", so that unlexing takes back exactly them. */
+        i = lexer->pos < lexer->stream.len ? lexer->pos
+            : lexer->stream.len - 1;
+        ++lexer->pos;
+        yfl_stream_load(lexer, i, token);
+        return i == lexer->stream.len - 1 ? lexer->stream.err : YFLC_OK;
+    }
+
+    if (lexer->ring)
+        return yfl_ring_read(lexer, token);
+
+    return yfl_lex_next(lexer, token);
+
+}
+
+enum yfl_code yfl_lex_next(struct yf_lexer * lexer, struct yf_token * token) {
+
     if (lexer->unlex_ct > 0) {
         /* We have unlexed tokens, so use them */
         *token = lexer->unlex_buf[lexer->unlex_ct - 1];
@@ -60,9 +322,20 @@ enum yfl_code yfl_lex(struct yf_lexer * lexer, struct yf_token * token) {
 }
 
 /**
- * Unlex one token (only up to 16!)
+ * Unlex one token (only up to 16, unless everything was lexed up front or a
+ * lexer thread is running!)
  */
 int yfl_unlex(struct yf_lexer * lexer, struct yf_token * token) {
+
+    if (lexer->stream.types) {
+        if (lexer->pos == 0)
+            return 1;
+        --lexer->pos;
+        return 0;
+    }
+
+    if (lexer->ring)
+        return yfl_ring_unlex(lexer);
     
     if (lexer->unlex_ct >= 16) {
         return 1;
@@ -75,86 +348,79 @@ int yfl_unlex(struct yf_lexer * lexer, struct yf_token * token) {
 }
 
 /**
- * Now, here's the way the lexer works. The first character of a token will
- * determine what type of token it is (ident, number, etc.), and also what
- * characters can end it. So we have functions that determine possible end types
- * from a beginning type, and then we consume characters until we reach an end.
+ * Now, here's the way the lexer works. Every character has a class, looked up
+ * in a table (see lex-tables.h). The class of the first character of a token
+ * determines what kind of token it is: identifiers and numbers run over
+ * letters, digits and underscores, and punctuation is fed through a state
+ * machine that finds the longest operator or punctuation token starting there.
+ * The tables are generated by scripts/gen-lexer-tables.py.
  */
 
-enum yfl_char_type {
-    /* Just a note - these are NOT the same as token types. */
-    YFL_UNKNOWN     = 0x00000000,
-    YFL_IDENT       = 0x00000001,
-    YFL_NUM         = 0x00000010,
-    YFL_PUNCT       = 0x00000100,
-    YFL_WHITESPACE  = 0x00001000,
-    YFL_EOF         = 0x00010000,
-};
-
-static enum yfl_char_type yfl_get_type(int c) {
-    
-    if (isalpha(c) || c == '_') {
-        return YFL_IDENT;
-    } else if (isdigit(c)) {
-        return YFL_NUM;
-    } else if (ispunct(c)) {
-        return YFL_PUNCT;
-    } else if (isspace(c)) {
-        return YFL_WHITESPACE;
-    } else if (c == EOF) {
-        return YFL_EOF;
-    } else {
-        return YFL_UNKNOWN;
-    }
-
+static inline int yfl_is_word_class(int cls) {
+    return cls == YFL_CC_IDENT || cls == YFL_CC_DIGIT;
 }
 
 /**
- * Get a bit field of all characters which end a token.
+ * Find the end of the operator or punctuation token at "start" - the longest
+ * match the state machine accepts - and set the token's type and operator. A
+ * character that starts no known token is a token of its own, and is left for
+ * the parser to reject.
  */
-static enum yfl_char_type yfl_end_types(enum yfl_char_type type) {
-
-    switch (type) {
-        /* There should be an error for this. */
-        case YFL_UNKNOWN:
-            return YFL_UNKNOWN;
-        case YFL_IDENT:
-            return YFL_PUNCT | YFL_WHITESPACE | YFL_EOF;
-        case YFL_NUM:
-            return YFL_PUNCT | YFL_WHITESPACE | YFL_EOF;
-        case YFL_PUNCT:
-            return YFL_IDENT | YFL_NUM | YFL_PUNCT | YFL_WHITESPACE | YFL_EOF;
-        /* Should also never happen. */
-        case YFL_WHITESPACE:
-        case YFL_EOF:
-            return YFL_UNKNOWN;
+static const char * yfl_scan_op(
+    const char * start, const char * end, struct yf_token * token
+) {
+
+    const char * p, * accept_end;
+    int cls, state, next;
+
+    token->type = YFT_OP;
+    accept_end = start + 1;
+    state = 1;
+    for (p = start; p != end; ++p) {
+        cls = yfl_char_class[(unsigned char) *p];
+        if (cls < YFL_CC_FIRST_OP)
+            break;
+        if ( (next = yfl_op_next[state][cls - YFL_CC_FIRST_OP]) == 0)
+            break;
+        state = next;
+        if (yfl_op_accept[state] != YFT_INVALID) {
+            token->type = yfl_op_accept[state];
+            token->op = yfl_op_code[state];
+            accept_end = p + 1;
+        }
     }
 
+    return accept_end;
+
 }
 
 /**
- * Get the token type from a charbuf.
+ * Find the end of the number at "start", and decode its value. Like an
+ * identifier, it runs over all letters, digits and underscores, but anything
+ * other than digits makes it invalid.
  */
-static enum yf_token_type get_type(char * buf) {
+static const char * yfl_scan_number(
+    const char * start, const char * end, struct yf_token * token
+) {
+
+    const char * p;
+    unsigned val = 0;
+
+    for (p = start; p != end
+        && yfl_char_class[(unsigned char) *p] == YFL_CC_DIGIT; ++p)
+        val = val * 10 + (*p - '0');
 
-    enum yf_token_type type;
-    if ((type = yf_keyword_type(buf)) != YFT_INVALID) {
-        return type;
+    token->type = YFT_LITERAL;
+    token->lit_val = (int) val;
+    token->lit_type = YFTL_INT;
+
+    if (p != end && yfl_char_class[(unsigned char) *p] == YFL_CC_IDENT) {
+        token->lit_type = YFTL_INVALID;
+        for (; p != end
+            && yfl_is_word_class(yfl_char_class[(unsigned char) *p]); ++p) {}
     }
 
-    if (isalpha(buf[0])) return YFT_IDENTIFIER;
-    if (isdigit(buf[0])) return YFT_LITERAL;
-    if (!strcmp(buf, "::")) return YFT_NAMESPACE;
-    if (buf[0] == ';') return YFT_SEMICOLON;
-    if (buf[0] == ',') return YFT_COMMA;
-    if (buf[0] == ':') return YFT_COLON;
-    if (buf[0] == '(') return YFT_OPAREN;
-    if (buf[0] == ')') return YFT_CPAREN;
-    if (buf[0] == '{') return YFT_OBRACE;
-    if (buf[0] == '}') return YFT_CBRACE;
-    if (buf[0] == '.') return YFT_DOT;
-    if (ispunct(buf[0])) return YFT_OP; /* More */
-    return YFT_INVALID;
+    return p;
 
 }
 
@@ -166,104 +432,85 @@ static enum yfl_code yfl_core_lex(
     struct yf_lexer * lexer, struct yf_token * token
 ) {
 
-    int startchar, curchar;
-    enum yfl_char_type starttype, endconditions;
-    int charpos; /* The character being added. */
+    const char * start, * p;
+    int cls;
+    size_t len;
+    const struct yfl_keyword * kw;
+    enum yf_alloc_tag prev_tag;
 
     /* Skip all irrelevant characters. */
     if (yfl_skip_all(lexer) == -1) return YFLC_OPEN_COMMENT;
 
     /* Get the start position */
-    token->loc = lexer->loc;
-
-    startchar = yfl_getc(lexer);
+    token->loc.file = lexer->file;
+    token->loc.offset = lexer->cur - lexer->base;
+    token->op = YFO_INVALID;
+    token->lit_type = YFTL_INVALID;
+    token->lit_val = 0;
 
     /* First, EOF check. */
-    if (startchar == EOF) {
+    if (lexer->cur == lexer->end) {
         token->type = YFT_EOF;
-        strcpy(token->data, "[EOF]");
-        lexer->input->close(lexer->input->input);
+        token->text = "[EOF]";
+        token->len = 5;
+        token->istr = NULL;
         return YFLC_OK;
     }
-    
-    /* Now, get the type of the first character. */
-    starttype = yfl_get_type(startchar);
-    endconditions = yfl_end_types(starttype);
-
-    charpos = 0;
-
-    curchar = startchar;
-
-    for (;;) {
-
-        token->data[charpos++] = curchar;
-
-        if (charpos >= 256) {
-            /* Too big! */
-            /* TODO - indicate an error. */
-            token->type = YFT_TOO_LARGE;
-            return YFLC_OVERFLOW;
-        }
-
-        /* Add characters until an end condition is encountered. */
-        curchar = yfl_getc(lexer);
-        if (yfl_get_type(curchar) & endconditions) {
-            /* This is kind of an ugly hack but oh well - if the first character
-            is an operator, and this is the next character and is an equals,
-            then lex it as one operator, like +=. */
-            if (starttype == YFL_PUNCT && curchar == '=' && charpos == 1) {
-                continue;
-            }
-            /* Another such 'ugly hack' for namespaces */
-            if (token->data[0] == ':' && curchar == ':' && charpos == 1) {
-                continue;
-            }
-            yfl_ungetc(lexer, curchar);
-            token->data[charpos] = '\0';
-            token->type = get_type(token->data);
-            return YFLC_OK;
-        }
 
+    start = lexer->cur;
+    cls = yfl_char_class[(unsigned char) *start];
+    switch (cls) {
+    case YFL_CC_IDENT:
+        for (p = start + 1; p != lexer->end
+            && yfl_is_word_class(yfl_char_class[(unsigned char) *p]); ++p) {}
+        token->type = YFT_IDENTIFIER;
+        break;
+    case YFL_CC_DIGIT:
+        /* A number with letters in it is still one token - the validator
+        complains about it, not us. */
+        p = yfl_scan_number(start, lexer->end, token);
+        break;
+    case YFL_CC_PUNCT:
+        p = start + 1;
+        token->type = YFT_OP;
+        break;
+    case YFL_CC_OTHER:
+        token->type = YFT_INVALID;
+        token->text = start;
+        token->len = 1;
+        token->istr = NULL;
+        return YFLC_UNKNOWN_ERROR;
+    default:
+        p = yfl_scan_op(start, lexer->end, token);
+        break;
     }
 
-}
+    len = p - start;
 
-/**
- * @brief This gets a character, but ALSO increments various properties of the
- * lexer, like line count and such, if needed.
- */
-static int yfl_getc(struct yf_lexer * lexer) {
+    lexer->cur = p;
 
-    int c;
-    c = lexer->input->getc(lexer->input->input);
+    token->text = start;
+    token->len = len;
 
-    if (c == '\n') {
-        ++lexer->loc.line;
-        lexer->prev_col = lexer->loc.column;
-        lexer->loc.column = 1;
-    } else {
-        ++lexer->loc.column;
+    if (token->type == YFT_IDENTIFIER
+        && (kw = yf_find_keyword(start, len)) != NULL) {
+        token->type = kw->type;
+        token->lit_type = kw->lit_type;
+        token->lit_val = kw->lit_val;
     }
 
-    return c;
-
-}
-
-static int yfl_ungetc(struct yf_lexer * lexer, int c) {
-
-    lexer->input->ungetc(c, lexer->input->input);
-
-    if (c != '\n') {
-        --lexer->loc.column;
+    /* Identifiers and literals are interned right away, so later stages never
+    need to hash or compare the text again. */
+    if (token->type == YFT_IDENTIFIER || token->type == YFT_LITERAL) {
+        prev_tag = yf_set_alloc_tag(YF_ALLOC_LEXER);
+        token->istr = lexer->interns
+            ? yf_intern_local_n(lexer->interns, start, len)
+            : yf_intern_n(start, len);
+        yf_set_alloc_tag(prev_tag);
     } else {
-        --lexer->loc.line;
-        /* This is why we need the prev_col. If we unlex a newline, we're at
-         * the end of the previous line, with an unknown column number. */
-        /* Let's just hope we never need to unlex across multiple lines. */
-        lexer->loc.column = lexer->prev_col;
+        token->istr = NULL;
     }
-
-    return 0;
+    return YFLC_OK;
 
 }
 
@@ -272,22 +519,11 @@ static int yfl_ungetc(struct yf_lexer * lexer, int c) {
  */
 static int yfl_skip_whitespace(struct yf_lexer * lexer) {
 
-    int c;
-    int skipped; /* The number of whitespace chars skipped */
-
-    skipped = 0;
+    const char * start = lexer->cur;
 
-    while (1) {
-        c = yfl_getc(lexer);
-        if (!isspace(c)) {
-            yfl_ungetc(lexer, c);
-            break;
-        }
-        ++skipped;
-    }
+    lexer->cur = yfl_scan_spaces(start, lexer->end);
 
-    /* Check the count. */
-    return skipped != 0;
+    return lexer->cur != start;
 
 }
 
@@ -297,53 +533,22 @@ static int yfl_skip_whitespace(struct yf_lexer * lexer) {
  */
 static int yfl_skip_comment(struct yf_lexer * lexer) {
 
-    int c;
-    int skipped; /* The number of comment chars skipped */
-
-    skipped = 0;
+    const char * close;
 
     /* Comments are delimited by two tildes on either side. */
-    c = yfl_getc(lexer);
-    if (c != '~') {
-        yfl_ungetc(lexer, c);
-        return 0;
-    }
-    c = yfl_getc(lexer);
-    if (c != '~') {
-        /* We're on the second char, so unlex both. */
-        yfl_ungetc(lexer, c);
-        yfl_ungetc(lexer, '~');
+    if (lexer->end - lexer->cur < 2
+        || lexer->cur[0] != '~' || lexer->cur[1] != '~')
         return 0;
-    }
-
-    skipped = 2; /* ~, and then ~ */
 
     /* Now we go through until we reach either two tildes or a file end. */
-    for (;;) {
-        c = yfl_getc(lexer);
-        if (c == '~') {
-            /* Is it the end of the comment??? */
-            c = yfl_getc(lexer);
-            if (c == '~') {
-                /* Yes, it is. */
-                skipped += 2;
-                break;
-            } else {
-                /* No, it's just a tilde alone. We were TRICKED! */
-                yfl_ungetc(lexer, c);
-                /* Don't forget to unlex the tilde. */
-                yfl_ungetc(lexer, '~');
-                skipped += 1;
-            }
-        }
-        if (c == EOF) {
-            /* We hit the end of the file. */
-            return -1;
-        }
+    close = yfl_scan_comment_end(lexer->cur + 2, lexer->end);
+    if (!close) {
+        /* We hit the end of the file. */
+        lexer->cur = lexer->end;
+        return -1;
     }
-
-    /* Check the count. */
-    return skipped != 0;
+    lexer->cur = close + 2;
+    return 1;
 
 }
 
@@ -392,7 +597,7 @@ const char * yf_get_toktype(enum yf_token_type type) {
         "<if>",
         "<else>",
         "namespace",
-        "[TOO LARGE]",
+        "dot",
     };
     
     return types[type];
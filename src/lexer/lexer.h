@@ -6,23 +6,79 @@
 #ifndef LEXER_LEXER_H
 #define LEXER_LEXER_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <api/lexer-input.h>
 #include <api/loc.h>
 #include <api/tokens.h>
 
-struct yf_lexer {
+/**
+ * A whole unit's tokens, lexed up front by yfl_lex_all. Each field of a token
+ * has an array of its own, indexed by token number, so that the parser's scans
+ * over the types and operators only touch the bytes they need. Token text is
+ * kept as its offset into the source, which is also its location.
+ */
+struct yf_token_stream {
+
+    size_t len, cap;
 
-    /* Current parsing data */
-    struct yf_location loc;
+    unsigned char * types;
+    unsigned char * ops;
+    unsigned char * lit_types;
+    int * lit_vals;
+    uint32_t * offsets;
+    uint32_t * lens;
+    const char ** istrs;
 
-    /* There's an explanation for this in yfl_ungetc */
-    int prev_col;
+    /* If lexing stopped on an error, the code - returned when the last token
+    is read, so the error comes up where it would have with streaming. */
+    int err;
+
+};
+
+/**
+ * How far back yfl_unlex can go while a lexer thread is running (see
+ * yfl_lex_thread). yfl_reset can always go back to its mark.
+ */
+#define YFL_RING_HISTORY 256
+
+struct yf_lexer {
+
+    /* The ID of the source, for token locations. */
+    uint32_t file;
 
     struct yf_lexer_input * input;
 
+    /* The source being scanned - "base" is its start, "cur" is the next
+    character, "end" is one past the last. Token locations are offsets from
+    "base". */
+    const char * base, * cur, * end;
+
+    /* The copy of a source read through callbacks, NULL for buffer input. */
+    char * owned_buf;
+
     struct yf_token unlex_buf[16];
     int unlex_ct;
 
+    /* Set up by yfl_lex_all - "types" is NULL until then. "pos" is the index
+    of the next token to read, from the stream or from the ring. It goes past
+    the last token when the end of file is read more than once. */
+    struct yf_token_stream stream;
+    size_t pos;
+
+    /* The number of marks not yet reset or released, and the position of the
+    oldest - a lexer thread keeps every token from there on. */
+    size_t marks;
+    size_t mark_pos;
+
+    /* Set up by yfl_lex_thread, NULL until then. */
+    struct yfl_ring * ring;
+
+    /* Where to intern identifiers and literals instead of the global pool -
+    only set for the chunks of yfl_lex_all_parallel. */
+    struct yf_intern_local * interns;
+
 };
 
 /**
@@ -33,7 +89,7 @@ enum yfl_code {
     YFLC_OK,
     YFLC_UNKNOWN_ERROR,
     YFLC_OPEN_COMMENT,
-    YFLC_OVERFLOW,
+    YFLC_MARK_TOO_FAR,
 
 };
 
@@ -49,30 +105,90 @@ char * get_error_message(int error_code);
 void yfl_lexer_error(int lex_err);
 
 /**
- * Init a lexer.
+ * Init a lexer, and register its source for locations (see api/loc.h). Return
+ * 0 on success, 1 if reading the input failed or it is too large (4 GiB or
+ * more).
  */
-void yfl_init(
+int yfl_init(
     struct yf_lexer * lexer,
     struct yf_lexer_input * input
 );
 
+/**
+ * Release whatever the lexer holds on to. The text of the tokens it returned
+ * may point into the source, so it is invalid afterwards - their interned
+ * strings stay valid.
+ */
+void yfl_cleanup(struct yf_lexer * lexer);
+
+/**
+ * Lex the rest of the input into the lexer's token stream. After this, yfl_lex
+ * reads from the stream, yfl_unlex has no limit, and yfl_mark and yfl_reset
+ * can be used. Lexing errors are not reported here, but by the yfl_lex call
+ * that reaches them. Return 1 if allocating the stream failed.
+ */
+int yfl_lex_all(struct yf_lexer * lexer);
+
+/**
+ * Same as yfl_lex_all, but the source is split into "jobs" chunks at line
+ * boundaries, which are lexed at the same time on that many threads. The
+ * tokens are exactly the ones yfl_lex_all would give. Return 1 if allocating
+ * the stream failed.
+ */
+int yfl_lex_all_parallel(struct yf_lexer * lexer, int jobs);
+
+/**
+ * Lex the rest of the input on a thread of its own, which fills a ring buffer
+ * of tokens that yfl_lex then takes from - so that lexing overlaps with
+ * whatever the caller does with the tokens. The thread waits whenever the ring
+ * is full. yfl_unlex and yfl_reset can go back YFL_RING_HISTORY tokens, and
+ * yfl_cleanup stops the thread. Return 1 if the thread could not be started.
+ */
+int yfl_lex_thread(struct yf_lexer * lexer);
+
 /**
  * Stuff a token with data.
  */
 enum yfl_code yfl_lex(struct yf_lexer * lexer, struct yf_token * token);
 
 /**
- * Unlex one token (only up to 16!) Return 1 if failed.
+ * Unlex one token (only up to 16, unless everything was lexed up front or a
+ * lexer thread is running!) Return 1 if failed.
  */
 int yfl_unlex(struct yf_lexer * lexer, struct yf_token * token);
 
 /**
- * Get the string of a token type.
+ * Remember the current position in the token stream, to go back to with
+ * yfl_reset. Only for a lexer that has lexed everything up front, or one with
+ * a lexer thread. Every mark must be either reset to or released - until then,
+ * a lexer thread holds on to the tokens after it, and reading more than its
+ * ring holds past the mark is an error (YFLC_MARK_TOO_FAR).
  */
-const char * yf_get_toktype(enum yf_token_type type);
+static inline size_t yfl_mark(struct yf_lexer * lexer) {
+    if (lexer->marks++ == 0)
+        lexer->mark_pos = lexer->pos;
+    return lexer->pos;
+}
+
+/**
+ * Drop a mark without going back to it. Marks are released in the reverse of
+ * the order they were made.
+ */
+static inline void yfl_release(struct yf_lexer * lexer) {
+    --lexer->marks;
+}
 
 /**
- * Unlex a token, up to 16.
+ * Go back to a mark, which is released.
  */
+static inline void yfl_reset(struct yf_lexer * lexer, size_t mark) {
+    lexer->pos = mark;
+    yfl_release(lexer);
+}
+
+/**
+ * Get the string of a token type.
+ */
+const char * yf_get_toktype(enum yf_token_type type);
 
 #endif /* LEXER_LEXER_H */
@@ -0,0 +1,230 @@
+/**
+ * Lexing one file on several threads. The file is cut into chunks that each
+ * end just after a newline, and every chunk is lexed on its own as if it
+ * started a file. The only thing that carries over a newline is a comment, so
+ * a chunk that turns out to start inside one (because the chunk before it
+ * ended in an unclosed comment) is lexed again from the end of the comment.
+ * Locations are offsets into the whole file, so the tokens of every chunk are
+ * right as they are, and are only put one after the other. Each chunk interns
+ * into a pool of its own, so the threads don't take turns on the global pool's
+ * lock - the merge moves the strings over, one chunk at a time.
+ */
+
+#include <lexer/lexer.h>
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <lexer/lexer-internal.h>
+#include <lexer/scan.h>
+#include <util/allocator.h>
+#include <util/intern.h>
+
+struct yfl_chunk {
+    struct yf_lexer lexer; /* Over just the chunk */
+    struct yf_token_stream stream;
+    struct yf_intern_local interns;
+    const char * start;
+    int error; /* Set if allocating the chunk's tokens failed */
+    bool threaded;
+    pthread_t thread;
+};
+
+static void * yfl_chunk_main(void * arg) {
+    struct yfl_chunk * c = arg;
+    yf_set_alloc_tag(YF_ALLOC_LEXER);
+    c->error = yfl_lex_into(&c->lexer, &c->stream);
+    return NULL;
+}
+
+static void yfl_chunk_init(
+    struct yfl_chunk * c, const struct yf_lexer * lexer,
+    const char * start, const char * end
+) {
+    memset(c, 0, sizeof *c);
+    c->lexer.file = lexer->file;
+    c->lexer.input = lexer->input;
+    c->lexer.base = lexer->base;
+    c->lexer.cur = start;
+    c->lexer.end = end;
+    c->lexer.interns = &c->interns;
+    c->start = start;
+}
+
+/**
+ * Cut the rest of the input into at most "jobs" chunks, of about the same
+ * size. There is always at least one, even for an empty input. Return how many
+ * there are.
+ */
+static int yfl_split(
+    struct yf_lexer * lexer, struct yfl_chunk * chunks, int jobs
+) {
+
+    const char * start = lexer->cur, * stop, * nl;
+    int n = 0;
+
+    do {
+        if (n == jobs - 1) {
+            stop = lexer->end;
+        } else {
+            stop = start + (lexer->end - start) / (jobs - n);
+            nl = memchr(stop, '\n', lexer->end - stop);
+            stop = nl ? nl + 1 : lexer->end;
+        }
+        yfl_chunk_init(&chunks[n++], lexer, start, stop);
+        start = stop;
+    } while (n < jobs && start != lexer->end);
+
+    return n;
+
+}
+
+/**
+ * Lex the chunk again, given that it starts inside a comment. Return 1 if the
+ * comment doesn't end in the chunk, so it has no tokens at all.
+ */
+static int yfl_relex_open(struct yfl_chunk * c) {
+
+    const char * close = yfl_scan_comment_end(c->start, c->lexer.end);
+
+    yfl_stream_free(&c->stream);
+    if (!close)
+        return 1;
+    c->lexer.cur = close + 2;
+    c->error = yfl_lex_into(&c->lexer, &c->stream);
+    return 0;
+
+}
+
+/**
+ * Intern a chunk's strings globally, and point the tokens from "first" on in
+ * the merged stream at those copies.
+ */
+static int yfl_publish(
+    struct yfl_chunk * c, struct yf_token_stream * dst, size_t first
+) {
+
+    size_t i;
+
+    if (yf_intern_publish(&c->interns))
+        return 1;
+    for (i = first; i < dst->len; ++i) {
+        if (dst->istrs[i])
+            dst->istrs[i] = yf_intern_global(dst->istrs[i]);
+    }
+    return 0;
+
+}
+
+/**
+ * Put the chunks' tokens one after the other, into the lexer's own stream.
+ * This has to go through the chunks in order, since whether a chunk starts
+ * inside a comment is only known once the one before it is settled.
+ */
+static int yfl_merge(
+    struct yf_lexer * lexer, struct yfl_chunk * chunks, int n
+) {
+
+    struct yf_token_stream * dst = &lexer->stream;
+    struct yf_token token;
+    struct yfl_chunk * c;
+    bool open = false, last;
+    size_t count, first, total = 0;
+    int i;
+
+    for (i = 0; i < n; ++i)
+        total += chunks[i].stream.len;
+    if (yfl_stream_reserve(dst, total + 1))
+        return 1;
+
+    for (i = 0; i < n; ++i) {
+
+        c = &chunks[i];
+        last = i == n - 1;
+
+        if (open && yfl_relex_open(c)) {
+            if (!last)
+                continue;
+            /* The file ends inside the comment. */
+            yfl_open_comment_token(&c->lexer, &token);
+            yfl_stream_store(dst, dst->len++, &token);
+            dst->err = YFLC_OPEN_COMMENT;
+            break;
+        }
+        if (c->error)
+            return 1;
+        if (dst->cap - dst->len < c->stream.len
+            && yfl_stream_reserve(dst, dst->len + c->stream.len + 1))
+            return 1;
+
+        /* Each chunk ends in an end of file, or the stand-in for an unclosed
+        comment, which only the last one keeps. */
+        count = c->stream.len;
+        open = c->stream.err == YFLC_OPEN_COMMENT && !last;
+        if (!last && (open || c->stream.err == YFLC_OK))
+            --count;
+        first = dst->len;
+        yfl_stream_append(dst, &c->stream, count);
+        if (yfl_publish(c, dst, first))
+            return 1;
+
+        if (!open && c->stream.err != YFLC_OK) {
+            dst->err = c->stream.err;
+            break;
+        }
+
+    }
+
+    return 0;
+
+}
+
+int yfl_lex_all_parallel(struct yf_lexer * lexer, int jobs) {
+
+    struct yfl_chunk * chunks;
+    enum yf_alloc_tag prev_tag;
+    int n, i, ret;
+
+    if (jobs < 2)
+        return yfl_lex_all(lexer);
+
+    prev_tag = yf_set_alloc_tag(YF_ALLOC_LEXER);
+    if ( (chunks = yf_malloc(sizeof (struct yfl_chunk) * jobs)) == NULL) {
+        yf_set_alloc_tag(prev_tag);
+        return 1;
+    }
+    n = yfl_split(lexer, chunks, jobs);
+
+    /* The first chunk is lexed here, and if a thread can't be had, its chunk
+    is too. */
+    for (i = 1; i < n; ++i) {
+        chunks[i].threaded = !pthread_create(
+            &chunks[i].thread, NULL, yfl_chunk_main, &chunks[i]
+        );
+    }
+    for (i = 0; i < n; ++i) {
+        if (!chunks[i].threaded)
+            yfl_chunk_main(&chunks[i]);
+    }
+    for (i = 1; i < n; ++i) {
+        if (chunks[i].threaded)
+            pthread_join(chunks[i].thread, NULL);
+    }
+
+    ret = yfl_merge(lexer, chunks, n);
+    if (ret)
+        yfl_stream_free(&lexer->stream);
+
+    for (i = 0; i < n; ++i) {
+        yfl_stream_free(&chunks[i].stream);
+        yf_intern_local_free(&chunks[i].interns);
+    }
+    yf_free(chunks);
+    yf_set_alloc_tag(prev_tag);
+
+    lexer->cur = lexer->end;
+    lexer->pos = 0;
+    return ret;
+
+}
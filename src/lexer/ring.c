@@ -0,0 +1,174 @@
+#include "ring.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+#include <lexer/lexer-internal.h>
+#include <util/allocator.h>
+
+/* The number of tokens in the ring - a power of two. */
+#define YFL_RING_SIZE 4096
+
+_Static_assert(YFL_RING_HISTORY < YFL_RING_SIZE, "ring too small");
+
+/* How long to spin before yielding the CPU while waiting on the other side. */
+#define YFL_RING_SPINS 256
+
+/**
+ * Token "n" (counting from the start of the file) is in slot n % YFL_RING_SIZE.
+ * The lexer thread owns the slots from head up to tail + YFL_RING_SIZE, and
+ * the parser the ones from tail up to head. The parser keeps the last
+ * YFL_RING_HISTORY tokens it has read, so it can go back to them, and all of
+ * the tokens after its oldest mark.
+ * Each side's counters are on a cache line of their own, so that they don't
+ * keep stealing it from each other.
+ */
+struct yfl_ring {
+
+    struct yfl_ring_slot {
+        struct yf_token token;
+        enum yfl_code code;
+    } slots[YFL_RING_SIZE];
+
+    /* Written by the lexer thread. "done" is set once the last token (the end
+    of file, or an error) is in. */
+    char pad1[64];
+    atomic_size_t head;
+    atomic_bool done;
+
+    /* Written by the parser thread. "stop" asks the lexer thread to give up. */
+    char pad2[64];
+    atomic_size_t tail;
+    atomic_bool stop;
+    char pad3[64];
+
+    pthread_t thread;
+
+};
+
+static void yfl_ring_wait(int * spins) {
+    if (++*spins < YFL_RING_SPINS)
+        return;
+    *spins = 0;
+    sched_yield();
+}
+
+static void * yfl_ring_main(void * arg) {
+
+    struct yf_lexer * lexer = arg;
+    struct yfl_ring * r = lexer->ring;
+    struct yfl_ring_slot * slot;
+    size_t head = 0;
+    int spins = 0;
+
+    yf_set_alloc_tag(YF_ALLOC_LEXER);
+
+    for (;;) {
+        while (head - atomic_load_explicit(&r->tail, memory_order_acquire)
+            == YFL_RING_SIZE) {
+            if (atomic_load_explicit(&r->stop, memory_order_relaxed))
+                goto out;
+            yfl_ring_wait(&spins);
+        }
+        slot = &r->slots[head % YFL_RING_SIZE];
+        slot->code = yfl_lex_next(lexer, &slot->token);
+        atomic_store_explicit(&r->head, ++head, memory_order_release);
+        if (slot->code != YFLC_OK || slot->token.type == YFT_EOF)
+            break;
+    }
+
+out:
+    atomic_store_explicit(&r->done, true, memory_order_release);
+    return NULL;
+
+}
+
+int yfl_lex_thread(struct yf_lexer * lexer) {
+
+    struct yfl_ring * r;
+
+    if ( (r = yf_malloc(sizeof (struct yfl_ring))) == NULL)
+        return 1;
+    atomic_init(&r->head, 0);
+    atomic_init(&r->done, false);
+    atomic_init(&r->tail, 0);
+    atomic_init(&r->stop, false);
+
+    lexer->ring = r;
+    lexer->pos = 0;
+    if (pthread_create(&r->thread, NULL, yfl_ring_main, lexer)) {
+        lexer->ring = NULL;
+        yf_free(r);
+        return 1;
+    }
+    return 0;
+
+}
+
+enum yfl_code yfl_ring_read(struct yf_lexer * lexer, struct yf_token * token) {
+
+    struct yfl_ring * r = lexer->ring;
+    struct yfl_ring_slot * slot;
+    size_t head, tail, keep;
+    int spins = 0;
+
+    tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+
+    for (;;) {
+        head = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (lexer->pos < head)
+            break;
+        if (atomic_load_explicit(&r->done, memory_order_acquire)) {
+            head = atomic_load_explicit(&r->head, memory_order_acquire);
+            if (lexer->pos < head)
+                break;
+            /* Reading past the end keeps returning the last token, and
+            counts as a read for yfl_ring_unlex. */
+            slot = &r->slots[(head - 1) % YFL_RING_SIZE];
+            *token = slot->token;
+            ++lexer->pos;
+            return slot->code;
+        }
+        /* A mark holds the tail back, so once the ring is full from there,
+        the lexer thread can't go on. */
+        if (lexer->pos - tail >= YFL_RING_SIZE) {
+            *token = r->slots[(lexer->pos - 1) % YFL_RING_SIZE].token;
+            return YFLC_MARK_TOO_FAR;
+        }
+        yfl_ring_wait(&spins);
+    }
+
+    slot = &r->slots[lexer->pos++ % YFL_RING_SIZE];
+    *token = slot->token;
+
+    /* Let go of the tokens that are too far back to return to, and not after
+    a mark. The parser may have gone back, so the tail must never move back
+    with it. */
+    if (lexer->pos > tail + YFL_RING_HISTORY) {
+        keep = lexer->pos - YFL_RING_HISTORY;
+        if (lexer->marks && keep > lexer->mark_pos)
+            keep = lexer->mark_pos;
+        if (keep > tail)
+            atomic_store_explicit(&r->tail, keep, memory_order_release);
+    }
+
+    return slot->code;
+
+}
+
+int yfl_ring_unlex(struct yf_lexer * lexer) {
+    if (lexer->pos == atomic_load_explicit(
+        &lexer->ring->tail, memory_order_relaxed))
+        return 1;
+    --lexer->pos;
+    return 0;
+}
+
+void yfl_ring_stop(struct yf_lexer * lexer) {
+    atomic_store_explicit(&lexer->ring->stop, true, memory_order_relaxed);
+    pthread_join(lexer->ring->thread, NULL);
+    yf_free(lexer->ring);
+    lexer->ring = NULL;
+}
@@ -0,0 +1,27 @@
+/**
+ * The token ring filled by a lexer thread (see yfl_lex_thread) - a lock-free
+ * single-producer, single-consumer queue. Internal to the lexer.
+ */
+
+#ifndef LEXER_RING_H
+#define LEXER_RING_H
+
+#include <lexer/lexer.h>
+
+/**
+ * Take the next token from the ring, waiting for the lexer thread if it has
+ * not lexed it yet.
+ */
+enum yfl_code yfl_ring_read(struct yf_lexer * lexer, struct yf_token * token);
+
+/**
+ * Step back one token. Return 1 if it has already been dropped from the ring.
+ */
+int yfl_ring_unlex(struct yf_lexer * lexer);
+
+/**
+ * Stop the lexer thread, and free the ring.
+ */
+void yfl_ring_stop(struct yf_lexer * lexer);
+
+#endif /* LEXER_RING_H */
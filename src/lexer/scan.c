@@ -0,0 +1,286 @@
+#include "scan.h"
+
+#include <stdatomic.h>
+#include <stddef.h> /* NULL */
+#include <stdint.h>
+
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(YFL_NO_SIMD)
+#define YFL_SCAN_X86
+#include <immintrin.h>
+#endif
+
+static inline int yfl_is_space(unsigned char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static const char * yfl_scan_spaces_scalar(const char * p, const char * end) {
+    for (; p != end && yfl_is_space(*p); ++p) {}
+    return p;
+}
+
+static const char * yfl_scan_comment_end_scalar(
+    const char * p, const char * end
+) {
+    for (; end - p >= 2; ++p) {
+        if (p[0] == '~' && p[1] == '~')
+            return p;
+    }
+    return NULL;
+}
+
+/**
+ * Record the line starting at p + i, if starts is not NULL.
+ */
+static inline void yfl_add_line(uint32_t * starts, size_t n, size_t i) {
+    if (starts)
+        starts[n] = i;
+}
+
+static size_t yfl_scan_line_starts_scalar(
+    const char * base, size_t i, size_t len, uint32_t * starts, size_t n
+) {
+    for (; i != len; ++i) {
+        if (base[i] == '\n')
+            yfl_add_line(starts, n++, i + 1);
+    }
+    return n;
+}
+
+#ifdef YFL_SCAN_X86
+
+/**
+ * Record the newlines set in "mask" (one bit per byte of the block at offset
+ * "i"), and return the new number of lines.
+ */
+static inline size_t yfl_add_lines_mask(
+    uint32_t * starts, size_t n, size_t i, uint32_t mask
+) {
+    if (!starts)
+        return n + __builtin_popcount(mask);
+    for (; mask; mask &= mask - 1)
+        starts[n++] = i + __builtin_ctz(mask) + 1;
+    return n;
+}
+
+/**
+ * The whitespace test for a block: ' ', or '\t' to '\r' - done as an unsigned
+ * (c - '\t') <= 4.
+ */
+static inline __m128i yfl_spaces_128(__m128i block) {
+    __m128i shifted = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+    __m128i ctrl = _mm_cmpeq_epi8(
+        _mm_min_epu8(shifted, _mm_set1_epi8(4)), shifted
+    );
+    return _mm_or_si128(ctrl, _mm_cmpeq_epi8(block, _mm_set1_epi8(' ')));
+}
+
+static const char * yfl_scan_spaces_sse2(const char * p, const char * end) {
+
+    uint32_t spaces;
+
+    for (; end - p >= 16; p += 16) {
+        spaces = _mm_movemask_epi8(
+            yfl_spaces_128(_mm_loadu_si128((const __m128i *) p))
+        );
+        if (spaces != 0xFFFF)
+            return p + __builtin_ctz(~spaces);
+    }
+
+    return yfl_scan_spaces_scalar(p, end);
+
+}
+
+static const char * yfl_scan_comment_end_sse2(
+    const char * p, const char * end
+) {
+
+    __m128i tilde = _mm_set1_epi8('~');
+    __m128i block, next;
+    uint32_t ends;
+
+    /* Each block is compared with itself shifted by one, so a "~~" that
+    straddles two blocks is still found. */
+    for (; end - p >= 17; p += 16) {
+        block = _mm_loadu_si128((const __m128i *) p);
+        next = _mm_loadu_si128((const __m128i *) (p + 1));
+        ends = _mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(block, tilde), _mm_cmpeq_epi8(next, tilde)
+        ));
+        if (ends)
+            return p + __builtin_ctz(ends);
+    }
+
+    return yfl_scan_comment_end_scalar(p, end);
+
+}
+
+static size_t yfl_scan_line_starts_sse2(
+    const char * base, size_t i, size_t len, uint32_t * starts, size_t n
+) {
+
+    __m128i block;
+
+    for (; len - i >= 16; i += 16) {
+        block = _mm_loadu_si128((const __m128i *) (base + i));
+        n = yfl_add_lines_mask(starts, n, i, _mm_movemask_epi8(
+            _mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))
+        ));
+    }
+
+    return yfl_scan_line_starts_scalar(base, i, len, starts, n);
+
+}
+
+__attribute__((target("avx2")))
+static inline __m256i yfl_spaces_256(__m256i block) {
+    __m256i shifted = _mm256_sub_epi8(block, _mm256_set1_epi8('\t'));
+    __m256i ctrl = _mm256_cmpeq_epi8(
+        _mm256_min_epu8(shifted, _mm256_set1_epi8(4)), shifted
+    );
+    return _mm256_or_si256(
+        ctrl, _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' '))
+    );
+}
+
+__attribute__((target("avx2")))
+static const char * yfl_scan_spaces_avx2(const char * p, const char * end) {
+
+    uint32_t spaces;
+
+    for (; end - p >= 32; p += 32) {
+        spaces = _mm256_movemask_epi8(
+            yfl_spaces_256(_mm256_loadu_si256((const __m256i *) p))
+        );
+        if (spaces != UINT32_MAX)
+            return p + __builtin_ctz(~spaces);
+    }
+
+    return yfl_scan_spaces_sse2(p, end);
+
+}
+
+__attribute__((target("avx2")))
+static const char * yfl_scan_comment_end_avx2(
+    const char * p, const char * end
+) {
+
+    __m256i tilde = _mm256_set1_epi8('~');
+    __m256i block, next;
+    uint32_t ends;
+
+    for (; end - p >= 33; p += 32) {
+        block = _mm256_loadu_si256((const __m256i *) p);
+        next = _mm256_loadu_si256((const __m256i *) (p + 1));
+        ends = _mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(block, tilde), _mm256_cmpeq_epi8(next, tilde)
+        ));
+        if (ends)
+            return p + __builtin_ctz(ends);
+    }
+
+    return yfl_scan_comment_end_sse2(p, end);
+
+}
+
+__attribute__((target("avx2")))
+static size_t yfl_scan_line_starts_avx2(
+    const char * base, size_t i, size_t len, uint32_t * starts, size_t n
+) {
+
+    __m256i block;
+
+    for (; len - i >= 32; i += 32) {
+        block = _mm256_loadu_si256((const __m256i *) (base + i));
+        n = yfl_add_lines_mask(starts, n, i, _mm256_movemask_epi8(
+            _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'))
+        ));
+    }
+
+    return yfl_scan_line_starts_sse2(base, i, len, starts, n);
+
+}
+
+#endif /* YFL_SCAN_X86 */
+
+enum yfl_scan_level {
+    YFL_SCAN_UNKNOWN,
+    YFL_SCAN_SCALAR,
+    YFL_SCAN_SSE2,
+    YFL_SCAN_AVX2,
+};
+
+/**
+ * The best implementation this CPU supports. Working it out twice (from two
+ * threads) is harmless, so it's only cached.
+ */
+static enum yfl_scan_level yfl_get_scan_level(void) {
+
+    static atomic_int level = YFL_SCAN_UNKNOWN;
+    int l = atomic_load_explicit(&level, memory_order_relaxed);
+
+    if (l != YFL_SCAN_UNKNOWN)
+        return l;
+
+#ifdef YFL_SCAN_X86
+    __builtin_cpu_init();
+    l = __builtin_cpu_supports("avx2") ? YFL_SCAN_AVX2 : YFL_SCAN_SSE2;
+#else
+    l = YFL_SCAN_SCALAR;
+#endif
+
+    atomic_store_explicit(&level, l, memory_order_relaxed);
+    return l;
+
+}
+
+const char * yfl_scan_spaces(const char * p, const char * end) {
+
+    /* Most gaps between tokens are a single space - don't bother with a
+    vector for those. */
+    if (p == end || !yfl_is_space(*p))
+        return p;
+    if (end - p < 2 || !yfl_is_space(p[1]))
+        return yfl_scan_spaces_scalar(p, end);
+
+    switch (yfl_get_scan_level()) {
+#ifdef YFL_SCAN_X86
+    case YFL_SCAN_AVX2:
+        return yfl_scan_spaces_avx2(p, end);
+    case YFL_SCAN_SSE2:
+        return yfl_scan_spaces_sse2(p, end);
+#endif
+    default:
+        return yfl_scan_spaces_scalar(p, end);
+    }
+
+}
+
+const char * yfl_scan_comment_end(const char * p, const char * end) {
+
+    switch (yfl_get_scan_level()) {
+#ifdef YFL_SCAN_X86
+    case YFL_SCAN_AVX2:
+        return yfl_scan_comment_end_avx2(p, end);
+    case YFL_SCAN_SSE2:
+        return yfl_scan_comment_end_sse2(p, end);
+#endif
+    default:
+        return yfl_scan_comment_end_scalar(p, end);
+    }
+
+}
+
+size_t yfl_scan_line_starts(const char * p, size_t len, uint32_t * starts) {
+
+    switch (yfl_get_scan_level()) {
+#ifdef YFL_SCAN_X86
+    case YFL_SCAN_AVX2:
+        return yfl_scan_line_starts_avx2(p, 0, len, starts, 0);
+    case YFL_SCAN_SSE2:
+        return yfl_scan_line_starts_sse2(p, 0, len, starts, 0);
+#endif
+    default:
+        return yfl_scan_line_starts_scalar(p, 0, len, starts, 0);
+    }
+
+}
@@ -0,0 +1,31 @@
+/**
+ * Fast scanning over the source buffer, for the stretches the lexer skips -
+ * whitespace and comments - and for finding the lines of a file. On x86-64
+ * these look at 16 or 32 bytes at a time with SSE2 or AVX2, picked at runtime,
+ * with a plain loop everywhere else.
+ */
+
+#ifndef LEXER_SCAN_H
+#define LEXER_SCAN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Return the first character in [p, end) that is not whitespace, or end.
+ */
+const char * yfl_scan_spaces(const char * p, const char * end);
+
+/**
+ * Return the first "~~" in [p, end), or NULL if there is none.
+ */
+const char * yfl_scan_comment_end(const char * p, const char * end);
+
+/**
+ * Find where every line of the "len" characters at p starts, other than the
+ * first - the offset of the character after each newline. Write them to
+ * "starts" if it's not NULL, and return how many there are.
+ */
+size_t yfl_scan_line_starts(const char * p, size_t len, uint32_t * starts);
+
+#endif /* LEXER_SCAN_H */
@@ -23,12 +23,12 @@ int yfp_if(struct yf_parse_node * node, struct yf_lexer * lexer) {
         YF_TOKERR(tok, "'('");
     }
 
-    i->cond = yf_malloc(sizeof (struct yf_parse_node));
+    i->cond = P_NEW_NODE();
     if (!i->cond)
         return 2;
 
     /* Parse the expression */
-    if (yfp_expr(i->cond, lexer, false, NULL)) {
+    if (yfp_expr(i->cond, lexer)) {
         return 1;
     }
 
@@ -38,7 +38,7 @@ int yfp_if(struct yf_parse_node * node, struct yf_lexer * lexer) {
     }
 
     /* Now parse a body. */
-    i->code = yf_malloc(sizeof (struct yf_parse_node));
+    i->code = P_NEW_NODE();
     if (!i->code)
         return 2;
     if (yfp_stmt(i->code, lexer)) {
@@ -48,13 +48,14 @@ int yfp_if(struct yf_parse_node * node, struct yf_lexer * lexer) {
     /* Now, see if there's an else clause. */
     P_LEX(lexer, &tok);
     if (tok.type == YFT_ELSE) {
-        i->elsebranch = yf_malloc(sizeof (struct yf_parse_node));
+        i->elsebranch = P_NEW_NODE();
         if (!i->elsebranch)
             return 2;
         if (yfp_stmt(i->elsebranch, lexer)) {
             return 1;
         }
     } else {
+        i->elsebranch = NULL;
         yfl_unlex(lexer, &tok);
     }
 
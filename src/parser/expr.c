@@ -59,14 +59,14 @@ int yfp_atomic_expr(struct yf_parse_node * node, struct yf_lexer * lexer) {
         }
         break;
     case YFT_LITERAL:
-    node->expr.type = YFCS_VALUE;
-        strcpy(
-            node->expr.value.literal.value, tok.data
-        );
+        node->expr.type = YFCS_VALUE;
+        node->expr.value.literal.value = tok.istr;
+        node->expr.value.literal.type = tok.lit_type;
+        node->expr.value.literal.val = tok.lit_val;
         node->expr.value.type = YFCS_LITERAL;
         break;
     case YFT_OPAREN:
-        if (yfp_expr(node, lexer, 0, NULL))
+        if (yfp_expr(node, lexer))
             return 1;
         P_LEX(lexer, &tok);
         if (tok.type != YFT_CPAREN) {
@@ -82,158 +82,95 @@ int yfp_atomic_expr(struct yf_parse_node * node, struct yf_lexer * lexer) {
 
 }
 
-static int yfp_sort_expr_tree(
-    struct yf_parse_node * nodes, int num_nodes,
-    enum yf_operator * operators, /* num_operators = num_nodes - 1 */
-    struct yf_location * operator_lines,
-    struct yf_parse_node * node
-);
-
 /**
- * Return values:
- * 0 - all OK
- * 1 - too many subbranches
- * 2 - invalid operator
- * first is whether the first atomic expr has already been parsed. If so, supply
- * the first node. This first node passed in will be copied - free it after
- * calling.
+ * Whether op, coming after an operand that follows prev, takes that operand
+ * from prev. It does if it binds more tightly, or if they're tied and
+ * right-associative. prev is YFO_INVALID at the start of an expression, where
+ * there is nothing to take it from.
  */
-int yfp_expr(struct yf_parse_node * node, struct yf_lexer * lexer,
-    bool first, struct yf_parse_node * first_node) {
+static bool yfp_binds_tighter(enum yf_operator op, enum yf_operator prev) {
 
-    struct yf_parse_node atomics[64];
-    enum yf_operator operators[63];
-    struct yf_location operator_lines[63]; /* The location of the operator */
+    if (prev == YFO_INVALID)
+        return true;
 
-    struct yf_token tok;
+    switch (yfo_prec(op, prev)) {
+    case GREATER:
+        return true;
+    case EQUAL:
+        return yf_get_operator_assoc(op) == YFOA_RIGHT;
+    default:
+        return false;
+    }
 
-    int i, lex_err;
+}
 
-    node->type = YFCS_EXPR;
+/**
+ * Precedence climbing. "node" is an operand that came after the operator
+ * "prev" - extend it with every operator that binds more tightly than prev,
+ * with the operand after each. Operators that bind more tightly still go to
+ * the right operand, in a recursive call, so the depth of the recursion only
+ * grows with the number of precedence levels, not with the length of the
+ * expression.
+ */
+static int yfp_binary_rest(
+    struct yf_parse_node * node, struct yf_lexer * lexer,
+    enum yf_operator prev
+) {
 
-    /**
-     * Explanation for this stage of the parsing algorithm - get all atomic
-     * expressions and operators. Like so:
-     * (a + b) * c(d) - e
-     * atomics, (a + b), c(d), e
-     * operators, *, -
-     */
-
-    /**
-     * We parse one atomic expr first, and then we parse [op], [atomic expr]
-     * until done.
-     */
-    if (!first) {
-        if (yfp_atomic_expr(&atomics[0], lexer)) {
-            return 4;
-        }
-    } else {
-        atomics[0] = *first_node;
-    }
+    struct yf_parse_node * left, * right;
+    struct yf_token tok;
+    int ret, lex_err;
 
-    P_GETCT(node, atomics[0]);
+    for (;;) {
 
-    for (i = 0; i < 64; i++) {
         P_LEX(lexer, &tok);
-        if (tok.type == YFT_OP) {
-            operators[i] = yf_get_operator(tok.data);
-            if (operators[i] == YFO_INVALID) {
-                /* TODO - error message */
-                YF_TOKERR(tok, "valid operator");
-                return 2;
-            }
-            operator_lines[i] = tok.loc;
-            if (yfp_atomic_expr(&atomics[i + 1], lexer)) {
-                return 4;
-            }
-        } else {
-            /* Not an error - we've simply reached the end. */
+        if (tok.type != YFT_OP || !yfp_binds_tighter(tok.op, prev)) {
+            /* Not an error - this operand is done. */
             yfl_unlex(lexer, &tok);
-            break;
+            return 0;
         }
-    }
+        if (tok.op == YFO_INVALID) {
+            YF_TOKERR(tok, "valid operator");
+        }
+
+        left = P_NEW_NODE();
+        right = P_NEW_NODE();
+        if (!left || !right) {
+            P_FREE_NODE(right);
+            P_FREE_NODE(left);
+            return 1;
+        }
+        if (yfp_atomic_expr(right, lexer))
+            return 4;
+        if ( (ret = yfp_binary_rest(right, lexer, tok.op)) != 0)
+            return ret;
+
+        /* The operand so far becomes the left side of the new node. */
+        *left = *node;
+        node->type = YFCS_EXPR;
+        node->loc = tok.loc;
+        node->expr.type = YFCS_BINARY;
+        node->expr.binary.op = tok.op;
+        node->expr.binary.left = left;
+        node->expr.binary.right = right;
 
-    /* Now we have all operators and atomics. */
-    return yfp_sort_expr_tree(
-        atomics, i + 1, operators, operator_lines, node
-    );
+    }
 
 }
 
 /**
- * Sorts the child <nodes> into a tree, where <node> is the pointer to that
- * tree.
+ * Parse a whole expression - atomic expressions with binary operators between
+ * them. Each binary node is located at its operator.
+ * Return values:
+ * 0 - all OK
+ * 1 - out of memory
+ * 4 - invalid operator, bad atomic expression, or a lexing error
  */
-static int yfp_sort_expr_tree(
-    struct yf_parse_node * nodes, int num_nodes,
-    enum yf_operator * operators, struct yf_location * operator_lines,
-    struct yf_parse_node * n_node
-) {
+int yfp_expr(struct yf_parse_node * node, struct yf_lexer * lexer) {
 
-    int i, index;
-    enum yfo_precedence prec;
-    struct yfcs_expr * node = &n_node->expr;
+    if (yfp_atomic_expr(node, lexer))
+        return 4;
 
-    /* First, trivial cases. */
-    if (num_nodes == 1) {
-        *node = nodes[0].expr;
-        return 0;
-    }
-    if (num_nodes == 2) {
-        node->type = YFCS_BINARY;
-        node->binary.op = operators[0];
-        node->binary.left = yf_malloc(sizeof(struct yf_parse_node));
-        node->binary.right = yf_malloc(sizeof(struct yf_parse_node));
-        if (!node->binary.left || !node->binary.right) {
-            return 1;
-        }
-        *node->binary.left = nodes[0];
-        *node->binary.right = nodes[1];
-        return 0;
-    }
-
-    /**
-     * We find the location of the lowest-precedence operator, and then split
-     * the expression tree based on it. If there are multiple tied operators,
-     * we choose the first one if right-associative, and the last one if left.
-     */
-    for (i = 0, index = 0; i < num_nodes - 1; i++) {
-        prec = yfo_prec(operators[i], operators[index]);
-        if (prec == LESS) {
-            index = i;
-        }
-        /* If left-associative and tied, we want the last. */
-        if (prec == EQUAL &&
-            yf_get_operator_assoc(operators[i]) == YFOA_LEFT
-        ) {
-            index = i;
-        }
-    }
-
-    n_node->loc = operator_lines[index];
-
-    /* Now that we have our splitting location, we recurse. */
-    node->type = YFCS_BINARY;
-    node->binary.left = yf_malloc(sizeof(struct yf_parse_node));
-    node->binary.right = yf_malloc(sizeof(struct yf_parse_node));
-    if (!node->binary.left || !node->binary.right) {
-        return 1;
-    }
-    node->binary.op = operators[index];
-    yfp_sort_expr_tree(
-        nodes,
-        index + 1,
-        operators,
-        operator_lines,
-        node->binary.left
-    );
-    yfp_sort_expr_tree(
-        nodes + index + 1,
-        num_nodes - index - 1,
-        operators + index + 1,
-        operator_lines + index + 1,
-        node->binary.right
-    );
-    return 0;
+    return yfp_binary_rest(node, lexer, YFO_INVALID);
 
 }
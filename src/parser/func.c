@@ -16,7 +16,7 @@ int yfp_funcdecl(struct yf_parse_node * node, struct yf_lexer * lexer) {
     int lex_err;
 
     /* Start arg list for writing */
-    yf_list_init(&node->funcdecl.params);
+    yf_vector_init_in(&node->funcdecl.params, yfp_arena);
     argct = 0;
 
     for (;;) {
@@ -40,7 +40,7 @@ int yfp_funcdecl(struct yf_parse_node * node, struct yf_lexer * lexer) {
         if (yfp_ident(&ident, lexer)) {
             return 1;
         }
-        argp = yf_malloc(sizeof(struct yf_parse_node));
+        argp = P_NEW_NODE();
         if (!argp) {
             return 1;
         }
@@ -51,14 +51,14 @@ int yfp_funcdecl(struct yf_parse_node * node, struct yf_lexer * lexer) {
         }
         argp->vardecl.name = ident;
         if (yfp_vardecl(argp, lexer)) {
-            free(argp);
+            P_FREE_NODE(argp);
             return 1;
         }
 
         ++argct;
 
         /* Add to arg list */
-        yf_list_add(&node->funcdecl.params, argp);
+        yf_vector_push(&node->funcdecl.params, argp);
 
     }
 
@@ -68,11 +68,11 @@ int yfp_funcdecl(struct yf_parse_node * node, struct yf_lexer * lexer) {
         if (tok.type != YFT_OBRACE) {
             /* Expect function body */
             YF_PRINT_ERROR(
-                "Expected ':' or '{' following function declaration, got '%s'",
-                tok.data
+                "Expected ':' or '{' following function declaration, got '%.*s'",
+                tok.len, tok.text
             );
         }
-        strcpy(node->funcdecl.ret.databuf, "void");
+        node->funcdecl.ret.name = yf_intern("void");
         P_GETCT(&node->funcdecl.ret, tok);
         /* Unlex opening brace */
         yfl_unlex(lexer, &tok);
@@ -88,7 +88,7 @@ int yfp_funcdecl(struct yf_parse_node * node, struct yf_lexer * lexer) {
 
 bodyp:
     node->type = YFCS_FUNCDECL;
-    node->funcdecl.body = yf_malloc(sizeof (struct yf_parse_node));
+    node->funcdecl.body = P_NEW_NODE();
     return yfp_bstmt(node->funcdecl.body, lexer);
 
 }
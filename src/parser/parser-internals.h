@@ -9,6 +9,7 @@
 #include <api/tokens.h>
 #include <lexer/lexer.h>
 #include <util/allocator.h>
+#include <util/intern.h>
 #include <util/yfc-out.h>
 
 /**
@@ -17,12 +18,12 @@
  */
 #define YF_TOKERR(tok, expected) do { \
     YF_PRINT_ERROR( \
-        "%s %d:%d: unexpected token '%s'; " \
+        "%s %d:%d: unexpected token '%.*s'; " \
         "expected %s, found token of type \"%s\"", \
-        tok.loc.file, \
-        tok.loc.line, \
-        tok.loc.column, \
-        tok.data, \
+        yf_loc_file(tok.loc), \
+        yf_loc_line(tok.loc), \
+        yf_loc_column(tok.loc), \
+        tok.len, tok.text, \
         expected, \
         yf_get_toktype(tok.type) \
     ); \
@@ -41,6 +42,27 @@
   yfl_unlex(lexer, tok); \
 } while (0)
 
+/**
+ * The arena that the tree being parsed is allocated from, set by yf_parse for
+ * the duration of the parse.
+ */
+extern _Thread_local struct yf_arena * yfp_arena;
+
+/**
+ * Allocate a parse node from the current arena.
+ */
+#define P_NEW_NODE() \
+  ((struct yf_parse_node *) yf_arena_alloc( \
+    yfp_arena, sizeof (struct yf_parse_node) \
+  ))
+
+/**
+ * Give a parse node that was discarded on an error path back to the arena, so
+ * the next P_NEW_NODE can reuse it.
+ */
+#define P_FREE_NODE(node) \
+  yf_arena_free(yfp_arena, (node), sizeof (struct yf_parse_node))
+
 /**
  * Set the node's position information to that of the tok.
  */
@@ -52,10 +74,7 @@ int yfp_program(struct yf_parse_node * node, struct yf_lexer * lexer);
 int yfp_vardecl(struct yf_parse_node * node, struct yf_lexer * lexer);
 int yfp_funcdecl(struct yf_parse_node * node, struct yf_lexer * lexer);
 int yfp_stmt(struct yf_parse_node * node, struct yf_lexer * lexer);
-int yfp_expr(
-  struct yf_parse_node * node, struct yf_lexer * lexer,
-  bool, struct yf_parse_node *
-);
+int yfp_expr(struct yf_parse_node * node, struct yf_lexer * lexer);
 int yfp_ident(struct yfcs_identifier * node, struct yf_lexer * lexer);
 int yfp_type(struct yfcs_type * node, struct yf_lexer * lexer);
 int yfp_bstmt(struct yf_parse_node * node, struct yf_lexer * lexer);
@@ -5,9 +5,24 @@
 
 #include <parser/parser-internals.h>
 
-int yf_parse(struct yf_lexer * lexer, struct yf_parse_node * tree) {
-    
-    return yfp_program(tree, lexer);
+_Thread_local struct yf_arena * yfp_arena;
+
+int yf_parse(
+    struct yf_lexer * lexer, struct yf_parse_node * tree,
+    struct yf_arena * arena
+) {
+
+    int ret;
+
+    /* The parser backtracks, so it needs the whole token stream - or a lexer
+    thread, which keeps enough tokens to go back to. */
+    if (!lexer->stream.types && !lexer->ring && yfl_lex_all(lexer))
+        return 1;
+
+    yfp_arena = arena;
+    ret = yfp_program(tree, lexer);
+    yfp_arena = NULL;
+    return ret;
 
 }
 
@@ -24,15 +39,13 @@ int yfp_program(struct yf_parse_node * node, struct yf_lexer * lexer) {
     struct yf_parse_node * decl;
 
     /* Unimportant */
-    node->loc.line = node->loc.column = -1;
+    node->loc.file = node->loc.offset = 0;
 
     node->type = YFCS_PROGRAM;
-    yf_list_init(&node->program.decls);
+    yf_vector_init_in(&node->program.decls, yfp_arena);
 
     for (;;) {
 
-        decl = yf_malloc(sizeof(struct yf_parse_node));
-
         /* Variable decls look like this to start:
          * [identifier] : [type] ...
          * And function decls like:
@@ -44,10 +57,13 @@ int yfp_program(struct yf_parse_node * node, struct yf_lexer * lexer) {
         /* Do end-of-file peek back here. */
         P_PEEK(lexer, &tok);
         if (tok.type == YFT_EOF) {
-            free(decl);
             return 0;
         }
-        
+
+        decl = P_NEW_NODE();
+        if (!decl)
+            return 1;
+
         yfp_ident(&ident, lexer);   
         P_GETCT(decl, ident);
 
@@ -56,7 +72,7 @@ int yfp_program(struct yf_parse_node * node, struct yf_lexer * lexer) {
             case YFT_COLON:
                 decl->vardecl.name = ident;
                 if (yfp_vardecl(decl, lexer)) {
-                    free(decl);
+                    P_FREE_NODE(decl);
                     return 1;
                 }
                 /* It's a top-level decl, so expect a semicolon. */
@@ -68,7 +84,7 @@ int yfp_program(struct yf_parse_node * node, struct yf_lexer * lexer) {
             case YFT_OPAREN:
                 decl->funcdecl.name = ident;
                 if (yfp_funcdecl(decl, lexer)) {
-                    free(decl);
+                    P_FREE_NODE(decl);
                     return 1;
                 }
                 break;
@@ -78,7 +94,7 @@ int yfp_program(struct yf_parse_node * node, struct yf_lexer * lexer) {
         }
 
         /* Now, we have a node - add it to the list. */
-        yf_list_add(&node->program.decls, decl);
+        yf_vector_push(&node->program.decls, decl);
 
     }
 
@@ -112,12 +128,15 @@ int yfp_vardecl(struct yf_parse_node * node, struct yf_lexer * lexer) {
     P_LEX(lexer, &tok);
     switch (tok.type) {
         case YFT_OP:
-        if (strcmp(tok.data, "=")) {
+        if (tok.op != YFO_ASSIGN) {
             YF_TOKERR(tok, "equal sign");
         }
-            node->vardecl.expr = yf_malloc(sizeof(struct yf_parse_node));
-            if (yfp_expr(node->vardecl.expr, lexer, 0, NULL)) {
-                free(node->vardecl.expr);
+            node->vardecl.expr = P_NEW_NODE();
+            if (!node->vardecl.expr)
+                return 1;
+            if (yfp_expr(node->vardecl.expr, lexer)) {
+                P_FREE_NODE(node->vardecl.expr);
+                node->vardecl.expr = NULL;
                 return 1;
             }
             break;
@@ -134,96 +153,106 @@ int yfp_vardecl(struct yf_parse_node * node, struct yf_lexer * lexer) {
 }
 
 /**
- * How this works:
- * We copy data into the prefix buffer until we stop encountering a sequence of
- * identifier - dot - identifier - dot ...
- * If it's a namespace separator, we start parsing the actual name. Otherwise,
- * we copy the "prefix" into the "actual" name and break.
+ * Parse a dotted name like a.b.c and return it interned. Names without dots
+ * are the common case, and are just the interned identifier token itself -
+ * only dotted names are copied together into a buffer.
  */
-int yfp_ident(struct yfcs_identifier * node, struct yf_lexer * lexer) {
-   
+static int yfp_dotted_name(struct yf_lexer * lexer, const char ** out) {
+
     int lex_err;
     struct yf_token tok;
-
-    P_PEEK(lexer, &tok);
-    P_GETCT(node, tok);
+    char buf[256];
+    size_t len, toklen;
 
     P_LEX(lexer, &tok);
     if (tok.type != YFT_IDENTIFIER) {
         YF_TOKERR(tok, "identifier");
-    } else {
-        strcpy(node->filepath, tok.data);
     }
+    *out = tok.istr;
+    len = 0;
 
     /* Go through the dot - identifier loop. */
     for (;;) {
-        
+
         P_LEX(lexer, &tok);
-        /* Either a dot or a namespace separator. */
-        switch (tok.type) {
-        case YFT_DOT:
-            /* Copy the dot into the prefix. */
-            strcat(node->filepath, tok.data);
-            goto cont;
-        case YFT_NAMESPACE:
-            goto parse_name;
-        default:
+        if (tok.type != YFT_DOT) {
             /* Unlex unimportant token. */
             yfl_unlex(lexer, &tok);
-            /* There's no prefix. */
-            strcpy(node->name, node->filepath);
-            //strcpy(node->filepath, lexer->input->identifier_prefix);
-            strcpy(node->filepath, "");
-            goto done;
+            break;
+        }
+
+        if (len == 0) {
+            len = yf_intern_len(*out);
+            memcpy(buf, *out, len);
         }
 
-cont:   P_LEX(lexer, &tok);
+        P_LEX(lexer, &tok);
         /* Should be an identifier. */
         if (tok.type != YFT_IDENTIFIER) {
             YF_TOKERR(tok, "identifier");
-        } else {
-            strcat(node->filepath, tok.data);
         }
 
+        toklen = yf_intern_len(tok.istr);
+        if (len + 1 + toklen >= sizeof buf) {
+            YF_PRINT_ERROR(
+                "%s %d:%d: name is too long",
+                yf_loc_file(tok.loc), yf_loc_line(tok.loc),
+                yf_loc_column(tok.loc)
+            );
+            return 1;
+        }
+        buf[len++] = '.';
+        memcpy(buf + len, tok.istr, toklen);
+        len += toklen;
+
     }
 
-parse_name:
+    if (len)
+        *out = yf_intern_n(buf, len);
+
+    return 0;
+
+}
+
+/**
+ * How this works:
+ * We parse a dotted name, which is the prefix if it's followed by a namespace
+ * separator. Then we parse the actual name the same way. Otherwise, the
+ * "prefix" was the actual name all along, and there's no prefix.
+ */
+int yfp_ident(struct yfcs_identifier * node, struct yf_lexer * lexer) {
+   
+    int lex_err;
+    struct yf_token tok;
+    const char * prefix;
+
+    P_PEEK(lexer, &tok);
+    P_GETCT(node, tok);
+
+    if (yfp_dotted_name(lexer, &prefix))
+        return 1;
+
     P_LEX(lexer, &tok);
-    if (tok.type != YFT_IDENTIFIER) {
-        YF_TOKERR(tok, "identifier");
-    } else {
-        strcpy(node->name, tok.data);
+    if (tok.type != YFT_NAMESPACE) {
+        /* Unlex unimportant token. */
+        yfl_unlex(lexer, &tok);
+        /* There's no prefix. */
+        node->name = prefix;
+        node->filepath = yf_intern("");
+        return 0;
     }
-    /* Go through the dot - identifier loop. Similar code to above. */
-    for (;;) {
-        
-        P_LEX(lexer, &tok);
-        /* Either a dot or a namespace separator. */
-        switch (tok.type) {
-        case YFT_DOT:
-            /* Copy the dot into the prefix. */
-            strcat(node->name, tok.data);
-            goto cont2;
-        case YFT_NAMESPACE:
-            YF_PRINT_ERROR("Multiple namespace separators are not "
-                "allowed.");
-        default:
-            /* Unlex unimportant token. */
-            yfl_unlex(lexer, &tok);
-            goto done;
-        }
 
-cont2:  P_LEX(lexer, &tok);
-        /* Should be an identifier. */
-        if (tok.type != YFT_IDENTIFIER) {
-            YF_TOKERR(tok, "identifier");
-        } else {
-            strcat(node->name, tok.data);
-        }
+    node->filepath = prefix;
+    if (yfp_dotted_name(lexer, &node->name))
+        return 1;
 
+    P_PEEK(lexer, &tok);
+    if (tok.type == YFT_NAMESPACE) {
+        YF_PRINT_ERROR("Multiple namespace separators are not "
+            "allowed.");
+        return 1;
     }
 
-done:
     return 0;
 
 }
@@ -237,7 +266,7 @@ int yfp_type(struct yfcs_type * node, struct yf_lexer * lexer) {
     if (tok.type != YFT_IDENTIFIER) {
         YF_TOKERR(tok, "identifier");
     } else {
-        strcpy(node->databuf, tok.data);
+        node->name = tok.istr;
     }
     return 0;
 }
@@ -258,7 +287,7 @@ int yfp_bstmt(struct yf_parse_node * node, struct yf_lexer * lexer) {
     P_GETCT(node, tok);
 
     node->type = YFCS_BSTMT;
-    yf_list_init(&node->bstmt.stmts);
+    yf_vector_init_in(&node->bstmt.stmts, yfp_arena);
 
     for (;;) {
         P_PEEK(lexer, &tok);
@@ -267,12 +296,14 @@ int yfp_bstmt(struct yf_parse_node * node, struct yf_lexer * lexer) {
             P_LEX(lexer, &tok);
             return 0;
         }
-        stmt = yf_malloc(sizeof (struct yf_parse_node));
+        stmt = P_NEW_NODE();
+        if (!stmt)
+            return 1;
         if (yfp_stmt(stmt, lexer)) {
-            free(stmt);
+            P_FREE_NODE(stmt);
             return 1;
         }
-        yf_list_add(&node->bstmt.stmts, stmt);
+        yf_vector_push(&node->bstmt.stmts, stmt);
     }
 
 }
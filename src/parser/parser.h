@@ -8,11 +8,17 @@
 
 #include <api/concrete-tree.h>
 #include <lexer/lexer.h>
+#include <util/allocator.h>
 
 /**
- * Parse data from lexer into tree.
+ * Parse data from lexer into tree. All nodes below the root are allocated from
+ * the arena. Unless a lexer thread is running (see yfl_lex_thread), whatever
+ * the lexer has not lexed yet is lexed up front (see yfl_lex_all) first.
  * Returns: error code, or 0 if successful.
  */
-int yf_parse(struct yf_lexer * lexer, struct yf_parse_node * tree);
+int yf_parse(
+    struct yf_lexer * lexer, struct yf_parse_node * tree,
+    struct yf_arena * arena
+);
 
 #endif /* PARSER_PARSER_H */
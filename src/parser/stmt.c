@@ -5,9 +5,10 @@
 int yfp_stmt(struct yf_parse_node * node, struct yf_lexer * lexer) {
 
     struct yf_token tok;
-    struct yf_parse_node ident;
+    struct yfcs_identifier ident;
     int lex_err, ret;
     bool expect_semicolon;
+    size_t mark;
 
     P_PEEK(lexer, &tok);
     P_GETCT(node, tok);
@@ -27,29 +28,30 @@ int yfp_stmt(struct yf_parse_node * node, struct yf_lexer * lexer) {
             goto out;
         case YFT_IDENTIFIER:
             expect_semicolon = true;
-            /* So here, it's either a vardecl or an expr. We don't know, and we
-            can't unlex a whole identifier, so we check the next token and enter
-            the appropriate parsing routine "in the middle". */
-            if (yfp_ident(&ident.expr.value.identifier, lexer))
-                return 1;
-            P_LEX(lexer, &tok);
+            /* So here, it's either a vardecl or an expr. Look past the
+            identifier to find out - if it's not a vardecl, go back to the start
+            and parse an expression. */
+            mark = yfl_mark(lexer);
+            if (yfp_ident(&ident, lexer)) {
+                ret = 1;
+                goto release;
+            }
+            if ((lex_err = yfl_lex(lexer, &tok)) > 0) {
+                YF_PRINT_ERROR("%s", get_error_message(lex_err));
+                ret = 4;
+                goto release;
+            }
             if (tok.type == YFT_COLON) {
-                /* TODO - reduce the copied code */
-                strcpy(
-                    node->vardecl.name.name,
-                    ident.expr.value.identifier.name
-                );
+                yfl_release(lexer);
+                node->vardecl.name = ident;
                 ret = yfp_vardecl(node, lexer);
-                goto out;
-            /* Expression or funccall */
-            } else if (tok.type == YFT_OP || tok.type == YFT_OPAREN) {
-                ret = yfp_expr(node, lexer, true, &ident);
-                goto out;
             } else {
-                YF_TOKERR(tok, "':' or operator");
+                yfl_reset(lexer, mark);
+                ret = yfp_expr(node, lexer);
             }
+            goto out;
         case YFT_OPAREN:
-            ret = yfp_expr(node, lexer, 0, NULL);
+            ret = yfp_expr(node, lexer);
             goto out;
         case YFT_RETURN:
             P_LEX(lexer, &tok);
@@ -61,10 +63,10 @@ int yfp_stmt(struct yf_parse_node * node, struct yf_lexer * lexer) {
                 ret = 0;
                 node->ret.expr = NULL;
             } else {
-                node->ret.expr = yf_malloc(sizeof(struct yf_parse_node));
+                node->ret.expr = P_NEW_NODE();
                 if (!node->ret.expr)
                     return 1;
-                ret = yfp_expr(node->ret.expr, lexer, false, NULL);
+                ret = yfp_expr(node->ret.expr, lexer);
             }
             goto out;
         case YFT_IF:
@@ -90,6 +92,11 @@ out:
 
     return ret;
 
+release:
+    /* The mark is dropped on an error, just like on success. */
+    yfl_release(lexer);
+    return ret;
+
 }
 
 /**
@@ -111,7 +118,7 @@ int yfp_funccall(struct yf_parse_node * node, struct yf_lexer * lexer) {
      */
 
     /* Start arg list for writing */
-    yf_list_init(&node->expr.call.args);
+    yf_vector_init_in(&node->expr.call.args, yfp_arena);
     argct = 0;
 
     for (;;) {
@@ -131,19 +138,19 @@ int yfp_funccall(struct yf_parse_node * node, struct yf_lexer * lexer) {
             yfl_unlex(lexer, &tok);
         }
 
-        argp = yf_malloc(sizeof(struct yf_parse_node));
+        argp = P_NEW_NODE();
         if (!argp) {
             return 1;
         }
 
-        if (yfp_expr(argp, lexer, 0, NULL)) {
+        if (yfp_expr(argp, lexer)) {
             return 1;
         }
 
         ++argct;
 
         /* Add to arg list */
-        yf_list_add(&node->expr.call.args, argp);
+        yf_vector_push(&node->expr.call.args, argp);
 
     }
 
@@ -1,18 +1,25 @@
 #include "symtab.h"
 
 #include <api/sym.h>
+#include <semantics/validate/validate-internal.h>
 #include <util/allocator.h>
 #include <util/yfc-out.h>
 
-static int yfs_add_var(struct yf_hashmap * symtab, struct yf_parse_node *);
-static int yfs_add_fn(struct yf_hashmap * symtab, struct yf_parse_node *);
+static int yfs_add_var(
+    struct yf_compile_analyse_job * data, struct yf_parse_node *
+);
+static int yfs_add_fn(
+    struct yf_compile_analyse_job * data, struct yf_parse_node *
+);
 
 int yfs_build_symtab(struct yf_compile_analyse_job * data) {
 
     struct yf_parse_node * node;
     int ret;
 
-    data->symtab.table = yfh_new();
+    data->symtab.table = yfh_new_in(
+        &data->arena, data->parse_tree.program.decls.len
+    );
     data->symtab.parent = NULL;
     if (!data->symtab.table) {
         YF_PRINT_ERROR("symtab: failed to allocate table");
@@ -20,14 +27,14 @@ int yfs_build_symtab(struct yf_compile_analyse_job * data) {
     }
     
     ret = 0;
-    YF_LIST_FOREACH(data->parse_tree.program.decls, node) {
+    YF_VECTOR_FOREACH(data->parse_tree.program.decls, node) {
         switch (node->type) {
             case YFCS_VARDECL:
-                if (yfs_add_var(data->symtab.table, node))
+                if (yfs_add_var(data, node))
                     ret = 1;
                 break;
             case YFCS_FUNCDECL:
-                if (yfs_add_fn(data->symtab.table, node))
+                if (yfs_add_fn(data, node))
                     ret = 1;
                 break;
             default:
@@ -40,11 +47,14 @@ int yfs_build_symtab(struct yf_compile_analyse_job * data) {
 
 }
 
-static int yfs_add_var(struct yf_hashmap * symtab, struct yf_parse_node * n) {
+static int yfs_add_var(
+    struct yf_compile_analyse_job * data, struct yf_parse_node * n
+) {
 
+    struct yf_hashmap * symtab = data->symtab.table;
     struct yfcs_vardecl * v = &n->vardecl;
     struct yf_sym * vsym, * dupl;
-    vsym = yf_malloc(sizeof (struct yf_sym));
+    vsym = yf_arena_alloc(&data->arena, sizeof (struct yf_sym));
     if (!vsym) return 3;
 
     vsym->type = YFS_VAR;
@@ -56,9 +66,9 @@ static int yfs_add_var(struct yf_hashmap * symtab, struct yf_parse_node * n) {
     if ( (dupl = yfh_get(symtab, vsym->var.name)) != NULL) {
         YF_PRINT_ERROR(
             "symtab: duplicate variable declaration '%s' (lines %d and %d)",
-            v->name.name, dupl->loc.line, vsym->loc.line
+            v->name.name, yf_loc_line(dupl->loc), yf_loc_line(vsym->loc)
         );
-        free(vsym);
+        yf_arena_free(&data->arena, vsym, sizeof (struct yf_sym));
         return 1;
     }
 
@@ -68,16 +78,21 @@ static int yfs_add_var(struct yf_hashmap * symtab, struct yf_parse_node * n) {
 
 }
 
-static int yfs_add_fn(struct yf_hashmap * symtab, struct yf_parse_node * f) {
+/**
+ * The signature is resolved here, once, against this file's types - so call
+ * sites (in this file or any other) only have to compare types.
+ */
+static int yfs_add_fn(
+    struct yf_compile_analyse_job * data, struct yf_parse_node * f
+) {
     
     struct yfcs_funcdecl * fn = &f->funcdecl;
 
     struct yf_sym * fsym;
     struct yf_parse_node * narg;
-    struct yfcs_vardecl * arg;
-    struct yfsn_param * param;
+    size_t i;
 
-    fsym = yf_malloc(sizeof (struct yf_sym));
+    fsym = yf_arena_alloc(&data->arena, sizeof (struct yf_sym));
     if (!fsym)
         return 3;
 
@@ -86,23 +101,28 @@ static int yfs_add_fn(struct yf_hashmap * symtab, struct yf_parse_node * f) {
 
     fsym->fn.name = fn->name.name;
 
-    yf_list_init(&fsym->fn.params);
+    /* A type that isn't found is left NULL here, and reported when the
+    function itself is validated. */
+    fsym->fn.rtype = yfv_get_type_t(data, fn->ret);
 
-    /* Adding parameters to symbol */
-    YF_LIST_FOREACH(fn->params, narg) {
-
-        arg = &narg->vardecl;
-        
-        param = yf_malloc(sizeof (struct yfsn_param));
-        if (!param) return 3;
+    fsym->fn.arity = fn->params.len;
 
-        param->name = arg->name.name;
-        param->type = arg->type.databuf;
-        yf_list_add(&fsym->fn.params, param);
+    fsym->fn.params = NULL;
+    if (fsym->fn.arity) {
+        fsym->fn.params = yf_arena_alloc(
+            &data->arena, sizeof (struct yfs_type *) * fsym->fn.arity
+        );
+        if (!fsym->fn.params)
+            return 3;
+    }
 
+    /* Adding parameters to symbol */
+    i = 0;
+    YF_VECTOR_FOREACH(fn->params, narg) {
+        fsym->fn.params[i++] = yfv_get_type_t(data, narg->vardecl.type);
     }
 
-    yfh_set(symtab, fsym->fn.name, fsym);
+    yfh_set(data->symtab.table, fsym->fn.name, fsym);
 
     return 0;
 
@@ -1,10 +1,67 @@
 #include "types.h"
 
-enum yfs_conversion_allowedness yfs_is_safe_conversion(
-    struct yfs_type * from, struct yfs_type * to
+#include <string.h>
+
+#include <util/allocator.h>
+#include <util/intern.h>
+
+/* All types are signed for now - unsigned types are not yet supported. */
+#define BUILTIN(tname, tsize, fmt) \
+    { .primitive = { .size = tsize, .type = fmt }, .kind = YFST_PRIMITIVE, \
+        .name = tname }
+
+/* The names are replaced by their interned copies in yfs_init_types. */
+struct yfs_type yfs_builtin_types[YFS_NUM_BUILTIN_TYPES] = {
+
+    /* "standard" types. */
+    [YFS_TYPE_ID_CHAR]   = BUILTIN("char",    8, YFS_INT  ),
+    [YFS_TYPE_ID_SHORT]  = BUILTIN("short",  16, YFS_INT  ),
+    [YFS_TYPE_ID_INT]    = BUILTIN("int",    32, YFS_INT  ),
+    [YFS_TYPE_ID_LONG]   = BUILTIN("long",   64, YFS_INT  ),
+    [YFS_TYPE_ID_VOID]   = BUILTIN("void",    0, YFS_NONE ),
+    [YFS_TYPE_ID_FLOAT]  = BUILTIN("float",  32, YFS_FLOAT),
+    [YFS_TYPE_ID_DOUBLE] = BUILTIN("double", 64, YFS_FLOAT),
+
+    /* Convenience types. */
+    [YFS_TYPE_ID_I16]    = BUILTIN("i16",    16, YFS_INT  ),
+    [YFS_TYPE_ID_I32]    = BUILTIN("i32",    32, YFS_INT  ),
+    [YFS_TYPE_ID_I64]    = BUILTIN("i64",    64, YFS_INT  ),
+    [YFS_TYPE_ID_F16]    = BUILTIN("f16",    16, YFS_FLOAT),
+    [YFS_TYPE_ID_F32]    = BUILTIN("f32",    32, YFS_FLOAT),
+    [YFS_TYPE_ID_F64]    = BUILTIN("f64",    64, YFS_FLOAT),
+
+    /* We're considering bool to be one bit for conversion purposes. */
+    [YFS_TYPE_ID_BOOL]   = BUILTIN("bool",    1, YFS_INT  ),
+
+};
+
+#undef BUILTIN
+
+/* Name -> builtin type. */
+static struct yf_hashmap * builtin_table;
+
+/**
+ * The conversion matrix - the result of converting from type ID "f" to type ID
+ * "t" is at [f * capacity + t]. "info" keeps a copy of every registered type,
+ * so that rows and columns can be filled in for new types without holding on
+ * to types that may have been freed since.
+ */
+static struct {
+    unsigned char * table;
+    struct yfs_type * info;
+    int num_types;
+    int capacity;
+} conversions;
+
+/**
+ * Work out whether a conversion is allowed from the types themselves. This is
+ * only used to fill in the conversion matrix.
+ */
+static enum yfs_conversion_allowedness yfs_derive_conversion(
+    const struct yfs_type * from, const struct yfs_type * to
 ) {
 
-    struct yfs_primitive_type * f, * t;
+    const struct yfs_primitive_type * f, * t;
 
     /* TODO - get user-defined conversion operators (should they exist) */
     if (from->kind != to->kind) {
@@ -31,6 +88,107 @@ enum yfs_conversion_allowedness yfs_is_safe_conversion(
 
 }
 
+/**
+ * Add a type to the conversion matrix, growing it if needed. The type's ID
+ * must be the next one in sequence.
+ */
+static int yfs_add_conversions(const struct yfs_type * type) {
+
+    int newcap, i, id = type->id;
+    unsigned char * newtable;
+    struct yfs_type * newinfo;
+
+    if (id == conversions.capacity) {
+        newcap = conversions.capacity ? conversions.capacity * 2 : 32;
+        newtable = yf_malloc((size_t) newcap * newcap);
+        newinfo = yf_realloc(
+            conversions.info, sizeof (struct yfs_type) * newcap
+        );
+        if (!newtable || !newinfo) {
+            yf_free(newtable);
+            if (newinfo)
+                conversions.info = newinfo;
+            return 1;
+        }
+        for (i = 0; i < conversions.num_types; ++i) {
+            memcpy(
+                newtable + (size_t) i * newcap,
+                conversions.table + (size_t) i * conversions.capacity,
+                conversions.num_types
+            );
+        }
+        yf_free(conversions.table);
+        conversions.table = newtable;
+        conversions.info = newinfo;
+        conversions.capacity = newcap;
+    }
+
+    conversions.info[id] = *type;
+    conversions.num_types = id + 1;
+
+    /* The new type's row and column. */
+    for (i = 0; i <= id; ++i) {
+        conversions.table[(size_t) id * conversions.capacity + i] =
+            yfs_derive_conversion(type, &conversions.info[i]);
+        conversions.table[(size_t) i * conversions.capacity + id] =
+            yfs_derive_conversion(&conversions.info[i], type);
+    }
+
+    return 0;
+
+}
+
+int yfs_init_types(void) {
+
+    int i;
+    struct yfs_type * type;
+
+    builtin_table = yfh_new_sized(YFS_NUM_BUILTIN_TYPES);
+    if (!builtin_table)
+        return 1;
+
+    for (i = 0; i < YFS_NUM_BUILTIN_TYPES; ++i) {
+        type = &yfs_builtin_types[i];
+        type->id = i;
+        if ( (type->name = yf_intern(type->name)) == NULL)
+            return 1;
+        if (yfh_set(builtin_table, type->name, type))
+            return 1;
+        if (yfs_add_conversions(type))
+            return 1;
+    }
+
+    return 0;
+
+}
+
+void yfs_cleanup_types(void) {
+    if (builtin_table) {
+        yfh_destroy(builtin_table, NULL);
+        builtin_table = NULL;
+    }
+    yf_free(conversions.table);
+    yf_free(conversions.info);
+    memset(&conversions, 0, sizeof conversions);
+}
+
+struct yfs_type * yfs_get_builtin_type(const char * name) {
+    return yfh_get(builtin_table, name);
+}
+
+int yfs_register_type(struct yfs_type * type) {
+    type->id = conversions.num_types;
+    return yfs_add_conversions(type);
+}
+
+enum yfs_conversion_allowedness yfs_is_safe_conversion(
+    struct yfs_type * from, struct yfs_type * to
+) {
+    return conversions.table[
+        (size_t) from->id * conversions.capacity + to->id
+    ];
+}
+
 const char * yfse_get_error_message(enum yfs_conversion_allowedness err) {
     static const char * errs[] = {
         "No error",
@@ -41,7 +199,7 @@ const char * yfse_get_error_message(enum yfs_conversion_allowedness err) {
     return errs[err];
 }
 
-struct yfs_type * yfse_get_expr_type(
+struct yfs_type * yfse_compute_expr_type(
     struct yfa_expr * expr, struct yf_compile_analyse_job * fdata
 ) {
 
@@ -54,13 +212,13 @@ struct yfs_type * yfse_get_expr_type(
     switch (expr->type) {
     case YFA_BINARY:
 
-        ltype = yfse_get_expr_type(expr->as.binary.left, fdata);
-        rtype = yfse_get_expr_type(expr->as.binary.right, fdata);
+        ltype = expr->as.binary.left->dtype;
+        rtype = expr->as.binary.right->dtype;
         lsize = ltype->primitive.size;
         rsize = rtype->primitive.size;
 
         if (yfo_is_bool(expr->as.binary.op)) {
-            return yfv_get_type_s(fdata, "bool");
+            return YFS_TYPE_BOOL;
         }
 
         if (yfo_is_assign(expr->as.binary.op)) {
@@ -83,9 +241,9 @@ struct yfs_type * yfse_get_expr_type(
         } else {
             switch (v->as.literal.type) {
             case YFAL_NUM:
-                return yfv_get_type_s(fdata, "int");
+                return YFS_TYPE_INT;
             case YFAL_BOOL:
-                return yfv_get_type_s(fdata, "bool");
+                return YFS_TYPE_BOOL;
             default:
                 YF_PRINT_ERROR("panic: Unknown literal type");
                 return NULL;
@@ -114,18 +272,18 @@ int yfs_output_diagnostics(
         /* TODO - reduce repetition */
         if (al == YFS_CONVERSION_LOSSY) {
             YF_PRINT_WARNING("%s %d:%d: %s when converting from %s to %s",
-                loc->file,
-                loc->line,
-                loc->column,
+                yf_loc_file(*loc),
+                yf_loc_line(*loc),
+                yf_loc_column(*loc),
                 yfse_get_error_message(al),
                 from->name,
                 to->name
             );
         } else {
             YF_PRINT_ERROR("%s %d:%d: %s when converting from %s to %s",
-                loc->file,
-                loc->line,
-                loc->column,
+                yf_loc_file(*loc),
+                yf_loc_line(*loc),
+                yf_loc_column(*loc),
                 yfse_get_error_message(al),
                 from->name,
                 to->name
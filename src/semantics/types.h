@@ -11,6 +11,59 @@
 #include <api/loc.h>
 #include <semantics/validate/validate-internal.h>
 
+/**
+ * The builtin types, in registry order. These are shared by every compilation
+ * unit and never change after yfs_init_types is called.
+ */
+enum yfs_builtin_type_id {
+    YFS_TYPE_ID_CHAR,
+    YFS_TYPE_ID_SHORT,
+    YFS_TYPE_ID_INT,
+    YFS_TYPE_ID_LONG,
+    YFS_TYPE_ID_VOID,
+    YFS_TYPE_ID_FLOAT,
+    YFS_TYPE_ID_DOUBLE,
+    YFS_TYPE_ID_I16,
+    YFS_TYPE_ID_I32,
+    YFS_TYPE_ID_I64,
+    YFS_TYPE_ID_F16,
+    YFS_TYPE_ID_F32,
+    YFS_TYPE_ID_F64,
+    YFS_TYPE_ID_BOOL,
+    YFS_NUM_BUILTIN_TYPES
+};
+
+extern struct yfs_type yfs_builtin_types[YFS_NUM_BUILTIN_TYPES];
+
+/* Handles for the builtin types that the compiler itself needs. */
+#define YFS_TYPE_INT  (&yfs_builtin_types[YFS_TYPE_ID_INT])
+#define YFS_TYPE_VOID (&yfs_builtin_types[YFS_TYPE_ID_VOID])
+#define YFS_TYPE_BOOL (&yfs_builtin_types[YFS_TYPE_ID_BOOL])
+
+/**
+ * Set up the builtin type registry. Must be called once, before any type is
+ * looked up. Return 0 on success, 1 on failure (memory error).
+ */
+int yfs_init_types(void);
+
+/**
+ * Destroy the builtin type registry. Must be called before interned strings are
+ * released.
+ */
+void yfs_cleanup_types(void);
+
+/**
+ * Look up a builtin type by its (interned) name. Returns NULL if there is no
+ * such builtin type.
+ */
+struct yfs_type * yfs_get_builtin_type(const char * name);
+
+/**
+ * Give a user-defined type its ID and work out its conversions to and from
+ * every other type. Return 0 on success, 1 on failure (memory error).
+ */
+int yfs_register_type(struct yfs_type * type);
+
 enum yfs_conversion_allowedness {
     YFS_CONVERSION_OK,
     YFS_CONVERSION_LOSSY, /* like i64 -> bool */
@@ -20,7 +73,8 @@ enum yfs_conversion_allowedness {
 
 /**
  * Whether the first type can be converted to the second without any possible
- * information loss.
+ * information loss. This is a lookup in a table that is filled in as types are
+ * registered, so both types must have been registered.
  */
 enum yfs_conversion_allowedness yfs_is_safe_conversion(
     struct yfs_type * from, struct yfs_type * to
@@ -28,7 +82,12 @@ enum yfs_conversion_allowedness yfs_is_safe_conversion(
 
 const char * yfse_get_error_message(enum yfs_conversion_allowedness err);
 
-struct yfs_type * yfse_get_expr_type(
+/**
+ * Determine the type of an expression from its operands. This does not
+ * recurse - the operands must have been validated already, so that their
+ * "dtype" is set. Returns NULL on failure.
+ */
+struct yfs_type * yfse_compute_expr_type(
     struct yfa_expr * expr, struct yf_compile_analyse_job * udata
 );
 
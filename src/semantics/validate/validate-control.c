@@ -15,24 +15,25 @@ int validate_if(
     
     ain->type = YFA_IF;
 
-    a->cond = yf_malloc(sizeof (struct yf_ast_node));
+    a->cond = yfv_alloc(validator, sizeof (struct yf_ast_node));
     if (!a->cond)
         return 2;
-    a->code = yf_malloc(sizeof (struct yf_ast_node));
+    a->code = yfv_alloc(validator, sizeof (struct yf_ast_node));
     if (!a->code)
         return 2;
 
     if (validate_expr(validator, c->cond, a->cond)) {
+        yfv_free(validator, a->cond, sizeof (struct yf_ast_node));
+        a->cond = NULL;
         validator->error = 1;
         return 1;
     }
     
-    if ( (t = yfse_get_expr_type(
-        &a->cond->expr, validator->udata
-    )) != yfv_get_type_s(validator->udata, "bool")) {
+    if ( (t = a->cond->expr.dtype) != YFS_TYPE_BOOL) {
         YF_PRINT_ERROR(
             "%s %d: %d: if condition must be of type bool, was %s",
-            cin->loc.file, cin->loc.line, cin->loc.column,
+            yf_loc_file(cin->loc), yf_loc_line(cin->loc),
+            yf_loc_column(cin->loc),
             t->name
         );
         validator->error = 1;
@@ -45,13 +46,12 @@ int validate_if(
         type, &if_always_returns
     )) {
         validator->error = 1;
-        yf_free(a->code);
         a->code = NULL;
         return 1;
     }
 
     if (c->elsebranch) {
-        a->elsebranch = yf_malloc(sizeof (struct yf_ast_node));
+        a->elsebranch = yfv_alloc(validator, sizeof (struct yf_ast_node));
         if (!a->elsebranch)
             return 2;
         if (validate_node(
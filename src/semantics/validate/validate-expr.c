@@ -1,7 +1,6 @@
 #include <semantics/validate/validate-internal.h>
 
 #include <ctype.h>
-#include <string.h>
 
 #include <api/abstract-tree.h>
 #include <semantics/types.h>
@@ -22,8 +21,7 @@ static int validate_value(
     struct yf_location * loc
 ) {
 
-    char * intparse;
-    char dig;
+    const char * intparse;
 
     /* If an identifier, make sure it actually exists. */
     if (c->type == YFCS_IDENT) {
@@ -34,9 +32,9 @@ static int validate_value(
         ) == -1) {
             YF_PRINT_ERROR(
                 "%s %d:%d: Unknown identifier '%s::%s'",
-                loc->file,
-                loc->line,
-                loc->column,
+                yf_loc_file(*loc),
+                yf_loc_line(*loc),
+                yf_loc_column(*loc),
                 c->identifier.filepath,
                 c->identifier.name
             );
@@ -47,42 +45,26 @@ static int validate_value(
 
         a->type = YFA_LITERAL;
 
-        if (isdigit(c->literal.value[0])) {
-
-            /* Parse integer literal */
+        /* The lexer has already decoded the value. */
+        switch (c->literal.type) {
+        case YFTL_INT:
             a->as.literal.type = YFAL_NUM;
-            a->as.literal.val = 0;
-
-            for (intparse = c->literal.value; *intparse; ++intparse) {
-                dig = *intparse - '0';
-                if (dig < 0 || dig > 9) {
-                    YF_PRINT_ERROR(
-                        "%s %d:%d: Invalid literal '%s', "
-                        "found invalid character '%c' in int literal",
-                        loc->file, loc->line, loc->column,
-                        c->literal.value, *intparse
-                    );
-                    return 1;
-                }
-                a->as.literal.val *= 10;
-                a->as.literal.val += dig;
-            }
-
-            return 0;
-
-        }
-
-        /* Check for 'true' or 'false' */
-        if (strcmp(c->literal.value, "true") == 0) {
-            a->as.literal.type = YFAL_BOOL;
-            a->as.literal.val = 1;
-            return 0;
-        }
-        if (strcmp(c->literal.value, "false") == 0) {
+            break;
+        case YFTL_BOOL:
             a->as.literal.type = YFAL_BOOL;
-            a->as.literal.val = 0;
-            return 0;
+            break;
+        case YFTL_INVALID:
+            for (intparse = c->literal.value; isdigit(*intparse); ++intparse)
+                ;
+            YF_PRINT_ERROR(
+                "%s %d:%d: Invalid literal '%s', "
+                "found invalid character '%c' in int literal",
+                yf_loc_file(*loc), yf_loc_line(*loc), yf_loc_column(*loc),
+                c->literal.value, *intparse
+            );
+            return 1;
         }
+        a->as.literal.val = c->literal.val;
 
     }
 
@@ -97,17 +79,17 @@ static int validate_binary(
 ) {
     /* First, if it's an assignment, the left side is a variable. */
     if (yfo_is_assign(c->op)) {
-        if (c->left->type != YFCS_VALUE) {
+        if (c->left->expr.type != YFCS_VALUE) {
             YF_PRINT_ERROR(
                 "%s %d:%d: Left side of assignment must not be compound",
-                loc->file, loc->line, loc->column
+                yf_loc_file(*loc), yf_loc_line(*loc), yf_loc_column(*loc)
             );
             return 1;
         }
         if (c->left->expr.value.type != YFCS_IDENT) {
             YF_PRINT_ERROR(
                 "%s %d:%d: Left side of assignment must be an identifier",
-                loc->file, loc->line, loc->column
+                yf_loc_file(*loc), yf_loc_line(*loc), yf_loc_column(*loc)
             );
             return 1;
         }
@@ -115,31 +97,32 @@ static int validate_binary(
 
     a->op = c->op;
 
-    a->left = yf_malloc(sizeof (struct yf_ast_node));
+    a->left = yfv_alloc(validator, sizeof (struct yf_ast_node));
     if (!a->left)
         return 2;
     if (validate_expr_e(
         validator, &c->left->expr, a->left, loc
     )) {
-        free(a->left);
+        yfv_free(validator, a->left, sizeof (struct yf_ast_node));
+        a->left = NULL;
         return 1;
     }
 
-    a->right = yf_malloc(sizeof (struct yf_ast_node));
+    a->right = yfv_alloc(validator, sizeof (struct yf_ast_node));
     if (!a->right)
         return 2;
     if (validate_expr_e(
         validator, &c->right->expr, a->right, loc
     )) {
-        free(a->right);
+        yfv_free(validator, a->right, sizeof (struct yf_ast_node));
         a->right = NULL;
         return 1;
     }
 
     /* Check that the types are compatible. */
     if (yfs_output_diagnostics(
-        yfse_get_expr_type(a->left, validator->udata),
-        yfse_get_expr_type(a->right, validator->udata),
+        a->left->dtype,
+        a->right->dtype,
         validator->udata,
         loc
     )) {
@@ -160,10 +143,8 @@ static int validate_funccall(
 
     struct yf_parse_node * carg;
     struct yf_ast_node   * aarg;
-    struct yfsn_param    * param;
-    struct yfs_type      * paramtype;
-
-    int lgres;
+    struct yfs_fn        * fn;
+    size_t argct, i;
 
     /* Make sure the function exists. */
     if (find_symbol(
@@ -171,9 +152,9 @@ static int validate_funccall(
     ) == -1) {
         YF_PRINT_ERROR(
             "%s %d:%d: Unknown function '%s'",
-            loc->file,
-            loc->line,
-            loc->column,
+            yf_loc_file(*loc),
+            yf_loc_line(*loc),
+            yf_loc_column(*loc),
             c->name.name
         );
         return 1;
@@ -183,78 +164,71 @@ static int validate_funccall(
     if (a->name->type != YFS_FN) {
         YF_PRINT_ERROR(
             "%s %d:%d: Identifier '%s' is not a function",
-            loc->file,
-            loc->line,
-            loc->column,
+            yf_loc_file(*loc),
+            yf_loc_line(*loc),
+            yf_loc_column(*loc),
             c->name.name
         );
         return 1;
     }
 
+    fn = &a->name->fn;
+
+    /* Check the number of arguments first. */
+    argct = c->args.len;
+    if (argct != fn->arity) {
+        YF_PRINT_ERROR(
+            "%s %d:%d: too %s arguments in function call",
+            yf_loc_file(*loc),
+            yf_loc_line(*loc),
+            yf_loc_column(*loc),
+            argct < fn->arity ? "few" : "many"
+        );
+        return 1;
+    }
+
     /* Go through the arguments and add them to the list, while making sure
-        * the types are compatible for each one and the number of arguments
-        * matches.
-        */
-    yf_list_init(&a->args);
-    yf_list_reset(&a->name->fn.params);
-    yf_list_reset(&c->args);
-    for (;;) {
-
-        aarg = yf_malloc(sizeof (struct yf_ast_node));
+     * the types are compatible for each one.
+     */
+    yf_vector_init_in(&a->args, &validator->udata->arena);
+    i = 0;
+    YF_VECTOR_FOREACH(c->args, carg) {
+
+        aarg = yfv_alloc(validator, sizeof (struct yf_ast_node));
         if (!aarg)
             return 2;
 
-        if (
-            yf_list_get(&a->name->fn.params, (void **) &param) !=
-            (lgres = yf_list_get(&c->args, (void **) &carg))
-        ) {
-            YF_PRINT_ERROR(
-                "%s %d:%d: too %s arguments in function call",
-                loc->file,
-                loc->line,
-                loc->column,
-                lgres ? "few" : "many"
-            );
-            yf_free(aarg);
-            return 1;
-        }
-        if (lgres == -1) {
-            yf_free(aarg);
-            break;
-        }
-
         if (validate_expr(
             validator, carg, aarg
         )) {
-            yf_free(aarg);
+            yfv_free(validator, aarg, sizeof (struct yf_ast_node));
             return 1;
         }
 
-        if ( (paramtype =
-            yfv_get_type_s(validator->udata, param->type)
-        ) == NULL) {
+        if (fn->params[i] == NULL) {
             YF_PRINT_ERROR(
-                "%s %d:%d: Uncaught type error: unknown type '%s'",
-                loc->file,
-                loc->line,
-                loc->column,
-                param->type
+                "%s %d:%d: Uncaught type error: parameter %zu of '%s' has an "
+                "unknown type",
+                yf_loc_file(*loc),
+                yf_loc_line(*loc),
+                yf_loc_column(*loc),
+                i + 1,
+                c->name.name
             );
             return 1;
         }
 
         if (yfs_output_diagnostics(
-            yfse_get_expr_type(&aarg->expr, validator->udata),
-            paramtype,
+            aarg->expr.dtype,
+            fn->params[i],
             validator->udata,
             loc
         )) {
             return 1;
         }
 
-        yf_list_add(&a->args, aarg);
-        yf_list_next(&c->args);
-        yf_list_next(&a->name->fn.params);
+        yf_vector_push(&a->args, aarg);
+        ++i;
 
     }
 
@@ -270,24 +244,32 @@ static int validate_expr_e(
     struct yfcs_expr * c, struct yfa_expr * a,
     struct yf_location * loc
 ) {
+
+    int err = 0;
     
     /* If this is unary - (just a value), ... */
     switch (c->type) {
 
     case YFCS_VALUE:
         a->type = YFA_VALUE;
-        return validate_value(validator, &c->value, &a->as.value, loc);
+        err = validate_value(validator, &c->value, &a->as.value, loc);
+        break;
 
     case YFCS_BINARY:
         a->type = YFA_BINARY;
-        return validate_binary(validator, &c->binary, &a->as.binary, loc);
+        err = validate_binary(validator, &c->binary, &a->as.binary, loc);
+        break;
 
     case YFCS_FUNCCALL:
         a->type = YFA_FUNCCALL;
-        return validate_funccall(validator, &c->call, &a->as.call, loc);
+        err = validate_funccall(validator, &c->call, &a->as.call, loc);
+        break;
     }
 
-    return 0;
+    /* The operands are done, so this is computed once, bottom-up. */
+    a->dtype = err ? NULL : yfse_compute_expr_type(a, validator->udata);
+
+    return err;
 
 }
 
@@ -29,9 +29,9 @@ int validate_funcdecl(
     )) == NULL) {
         YF_PRINT_ERROR(
             "%s %d:%d: return type not found",
-            cin->loc.file,
-            cin->loc.line,
-            cin->loc.column
+            yf_loc_file(cin->loc),
+            yf_loc_line(cin->loc),
+            yf_loc_column(cin->loc)
         );
         return 2;
     }
@@ -41,40 +41,41 @@ int validate_funcdecl(
     enter_scope(validator, &a->param_scope);
 
     /* Add the arguments to the scope. */
-    yf_list_init(&a->params);
-    YF_LIST_FOREACH(c->params, cv) {
-        av = yf_malloc(sizeof (struct yf_ast_node));
+    yf_vector_init_in(&a->params, &validator->udata->arena);
+    YF_VECTOR_FOREACH(c->params, cv) {
+        av = yfv_alloc(validator, sizeof (struct yf_ast_node));
         if (!av)
             return 2;
         if (validate_vardecl(validator, cv, av)) {
-            yf_free(av);
             validator->error = 1;
+            exit_scope(validator);
             return 1;
         }
-        yf_list_add(&a->params, av);
+        yf_vector_push(&a->params, av);
     }
 
     /* Validate the return type. */
     if ((a->ret = yfv_get_type_t(validator->udata, c->ret)) == NULL) {
         YF_PRINT_ERROR(
             "%s %d:%d: Unknown return type '%s' of function '%s'",
-            cin->loc.file,
-            cin->loc.line,
-            cin->loc.column,
-            c->ret.databuf,
+            yf_loc_file(cin->loc),
+            yf_loc_line(cin->loc),
+            yf_loc_column(cin->loc),
+            c->ret.name,
             c->name.name
         );
+        exit_scope(validator);
         return 1;
     }
 
-    a->body = yf_malloc(sizeof (struct yf_ast_node));
+    a->body = yfv_alloc(validator, sizeof (struct yf_ast_node));
     if (!a->body)
         return 2;
 
     /* Now, validate the body. */
     if (validate_bstmt(validator, c->body, a->body, a->ret, &returns)) {
-        yf_free(a->body);
         a->body = NULL;
+        exit_scope(validator);
         return 1;
     }
 
@@ -84,9 +85,9 @@ int validate_funcdecl(
     if (returns == 0 && a->ret->primitive.size != 0) {
         YF_PRINT_ERROR(
             "%s %d:%d: Function '%s' does not always return a value",
-            cin->loc.file,
-            cin->loc.line,
-            cin->loc.column,
+            yf_loc_file(cin->loc),
+            yf_loc_line(cin->loc),
+            yf_loc_column(cin->loc),
             c->name.name
         );
         return 1;
@@ -117,11 +118,11 @@ int validate_bstmt(
     enter_scope(validator, &a->symtab);
 
     /* Validate each statement */
-    yf_list_init(&a->stmts);
+    yf_vector_init_in(&a->stmts, &validator->udata->arena);
 
     *returns = 0;
 
-    YF_LIST_FOREACH(c->stmts, csub) {
+    YF_VECTOR_FOREACH(c->stmts, csub) {
 
         /* If this comes after a return, none of it will be executed. */
         if (*returns && !ret_warning_reported) {
@@ -129,25 +130,25 @@ int validate_bstmt(
             YF_PRINT_WARNING(
                 "File %s: code on line %d until the end of the current "
                 "block will never execute",
-                csub->loc.file,
-                csub->loc.line
+                yf_loc_file(csub->loc),
+                yf_loc_line(csub->loc)
             );
         }
         
         /* Construct abstract instance */
-        asub = yf_malloc(sizeof (struct yf_ast_node));
+        asub = yfv_alloc(validator, sizeof (struct yf_ast_node));
         if (!asub)
             return 2;
 
         /* Validate */
         if (validate_node(validator, csub, asub, type, returns)) {
-            yf_free(asub);
+            yfv_free(validator, asub, sizeof (struct yf_ast_node));
             validator->error = 1;
             err = 1;
         } else {
 
             /* Move to abstract list */
-            yf_list_add(&a->stmts, asub);
+            yf_vector_push(&a->stmts, asub);
 
             /* Probably redundant */
             if (asub->type == YFA_RETURN) {
@@ -10,18 +10,88 @@
 #include <api/concrete-tree.h>
 #include <api/operator.h>
 #include <util/allocator.h>
+#include <util/intern.h>
 #include <util/yfc-out.h>
 
+/**
+ * A name that is visible at the current point of validation.
+ */
+struct yfv_binding {
+    const char * name;
+    struct yf_sym * sym;
+    /* The binding of the same name in an enclosing scope, or NULL. */
+    struct yfv_binding * shadowed;
+    /* How many scopes deep the declaration is - globals are at 0. */
+    int depth;
+};
+
+/**
+ * Every name visible at the current point of validation, in a single table
+ * per compilation unit. Each name maps to its innermost binding, which links
+ * to the binding it shadows. Entering a scope only records how many bindings
+ * exist, and exiting one pops the bindings made since then, putting back what
+ * they shadowed. So entering and exiting are O(1) (apart from the symbols
+ * actually declared), and a lookup is a single probe no matter how deeply the
+ * scopes are nested.
+ */
+struct yfv_scopes {
+
+    /* Name -> innermost binding. A name that is out of scope has no entry -
+    popping a binding puts back the one it shadowed, or removes the key. */
+    struct yf_hashmap * names;
+
+    /* All live bindings, innermost last. */
+    struct yfv_binding ** bindings;
+    size_t num_bindings, bindings_cap;
+
+    /* The number of live bindings when each scope was entered. */
+    size_t * marks;
+    size_t marks_cap;
+    int depth;
+
+    /* Popped bindings, linked through "shadowed", for reuse. */
+    struct yfv_binding * free_bindings;
+
+};
+
 /**
  * A struct containing all current validator information.
  */
 struct yfv_validator {
     struct yf_compilation_data * pdata;
     struct yf_compile_analyse_job * udata;
+    /**
+     * The symbol table of the current block. These are only kept as views for
+     * code generation and cleanup - all lookups go through "scopes".
+     */
     struct yfs_symtab * current_scope;
+    struct yfv_scopes scopes;
     int error;
 };
 
+/**
+ * Allocate memory that lives as long as the compilation unit.
+ */
+static inline void * yfv_alloc(struct yfv_validator * v, size_t size) {
+    return yf_arena_alloc(&v->udata->arena, size);
+}
+
+/**
+ * Give memory from yfv_alloc back to the unit's arena, for nodes that are
+ * discarded on an error path. Nothing may still point to it.
+ */
+static inline void yfv_free(struct yfv_validator * v, void * ptr, size_t size) {
+    yf_arena_free(&v->udata->arena, ptr, size);
+}
+
+/**
+ * Set up the scope table with all global symbols of the unit. Return 0 on
+ * success, 1 on failure (memory error).
+ */
+int yfv_scopes_init(struct yfv_validator * v);
+
+void yfv_scopes_destroy(struct yfv_validator * v);
+
 /**
  * Search for a symbol with the given name. Return "depth" - innermost scope is
  * 0, the next-enclosing is 1, etc. If not found, -1.
@@ -32,6 +102,16 @@ int find_symbol(
     struct yfcs_identifier * name
 );
 
+/**
+ * Declare a symbol in the current (non-global) scope. Return 0 on success, 1
+ * on failure (memory error).
+ */
+int declare_symbol(
+    struct yfv_validator * v,
+    const char * name,
+    struct yf_sym * sym
+);
+
 /**
  * Create a new scope - return 0 on success, 1 on failure (memory error).
  * The root of the created symtab is set to the current scope, and the current
@@ -108,11 +188,11 @@ struct yfs_type * yfv_get_type_t(
 );
 
 /**
- * Get a type from a file's type table, given a string.
+ * Get a type from a file's type table, given an interned string.
  */
 struct yfs_type * yfv_get_type_s(
     struct yf_compile_analyse_job * udata,
-    char * typestr
+    const char * typestr
 );
 
 #endif /* SEMANTICS_VALIDATE_UTILS_H */
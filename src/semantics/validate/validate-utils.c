@@ -2,10 +2,88 @@
 
 #include <string.h>
 
+#include <semantics/types.h>
 #include <util/yfc-out.h>
 
+int yfv_scopes_init(struct yfv_validator * v) {
+
+    struct yfv_scopes * s = &v->scopes;
+    struct yf_hashmap * globals = v->udata->symtab.table;
+    struct yfh_entry * entry;
+    struct yfv_binding * b;
+
+    s->names = yfh_new_sized(yfh_size(globals));
+    s->bindings = NULL;
+    s->num_bindings = s->bindings_cap = 0;
+    s->marks = NULL;
+    s->marks_cap = 0;
+    s->depth = 0;
+    s->free_bindings = NULL;
+    if (!s->names)
+        return 1;
+
+    /* Globals are never popped, so they don't go in the binding list. */
+    YFH_FOREACH(globals, entry) {
+        b = yf_malloc(sizeof (struct yfv_binding));
+        if (!b)
+            return 1;
+        b->name = entry->key;
+        b->sym = entry->value;
+        b->shadowed = NULL;
+        b->depth = 0;
+        if (yfh_set(s->names, b->name, b)) {
+            yf_free(b);
+            return 1;
+        }
+    }
+
+    return 0;
+
+}
+
+/**
+ * Take a popped binding's name back to whatever it shadowed, or out of the
+ * table if it shadowed nothing.
+ */
+static void yfv_unbind(struct yfv_scopes * s, struct yfv_binding * b) {
+    if (b->shadowed)
+        yfh_set(s->names, b->name, b->shadowed);
+    else
+        yfh_remove(s->names, b->name);
+}
+
+void yfv_scopes_destroy(struct yfv_validator * v) {
+
+    struct yfv_scopes * s = &v->scopes;
+    struct yfv_binding * b;
+    struct yfh_entry * entry;
+
+    /* Pop anything left open by an error, so only globals remain mapped. */
+    while (s->num_bindings) {
+        b = s->bindings[--s->num_bindings];
+        yfv_unbind(s, b);
+        b->shadowed = s->free_bindings;
+        s->free_bindings = b;
+    }
+    while ( (b = s->free_bindings) != NULL) {
+        s->free_bindings = b->shadowed;
+        yf_free(b);
+    }
+
+    if (s->names) {
+        YFH_FOREACH(s->names, entry) {
+            yf_free(entry->value);
+        }
+        yfh_destroy(s->names, NULL);
+    }
+    yf_free(s->bindings);
+    yf_free(s->marks);
+
+}
+
 /**
- * Look up a name in a given scope.
+ * Look up a name in the current scope. Since every visible name is in the one
+ * table, the innermost declaration is found directly.
  * EXAMPLE:
  * x: int = 3; ~~ This scope last ~~
  * foo() {
@@ -16,19 +94,15 @@
  * }
  */
 static int find_symbol_from_scope(
-    struct yfs_symtab * symtab,
+    struct yfv_scopes * scopes,
     struct yf_sym ** sym,
-    char * name
+    const char * name
 ) {
-    int depth = 0;
-    while (symtab != NULL) {
-        if ( (*sym = yfh_get(symtab->table, name)) != NULL) {
-            return depth;
-        }
-        depth++;
-        symtab = symtab->parent;
-    }
-    return -1;
+    struct yfv_binding * b = yfh_get(scopes->names, name);
+    if (b == NULL)
+        return -1;
+    *sym = b->sym;
+    return scopes->depth - b->depth;
 }
 
 /**
@@ -40,13 +114,14 @@ int find_symbol(
     struct yf_sym ** sym,
     struct yfcs_identifier * name
 ) {
-    if (!strcmp(name->filepath, "")) {
+    if (name->filepath[0] == '\0') {
         return find_symbol_from_scope(
-            validator->current_scope,
+            &validator->scopes,
             sym,
             name->name
         );
     } else {
+        /* Other modules only have a global scope. */
         struct yfs_symtab * symtab = yfh_get(
             validator->pdata->symtables, name->filepath
         );
@@ -54,30 +129,86 @@ int find_symbol(
             YF_PRINT_ERROR("Could not find module: %s", name->filepath);
             return -1;
         }
-        return find_symbol_from_scope(
-            symtab,
-            sym,
-            name->name
+        return (*sym = yfh_get(symtab->table, name->name)) ? 0 : -1;
+    }
+}
+
+int declare_symbol(
+    struct yfv_validator * v,
+    const char * name,
+    struct yf_sym * sym
+) {
+
+    struct yfv_scopes * s = &v->scopes;
+    struct yfv_binding * b, ** newbindings;
+    size_t newcap;
+
+    /* The current block owns the symbol, for codegen and cleanup. */
+    if (!v->current_scope->table) {
+        if ( (v->current_scope->table = yfh_new_in(
+            &v->udata->arena, YFH_DEFAULT_CAPACITY
+        )) == NULL)
+            return 1;
+    }
+    if (yfh_set(v->current_scope->table, name, sym))
+        return 1;
+
+    if (s->num_bindings == s->bindings_cap) {
+        newcap = s->bindings_cap ? s->bindings_cap * 2 : 64;
+        newbindings = yf_realloc(
+            s->bindings, sizeof (struct yfv_binding *) * newcap
         );
+        if (!newbindings)
+            return 1;
+        s->bindings = newbindings;
+        s->bindings_cap = newcap;
+    }
+
+    if ( (b = s->free_bindings) != NULL) {
+        s->free_bindings = b->shadowed;
+    } else if ( (b = yf_malloc(sizeof (struct yfv_binding))) == NULL) {
+        return 1;
+    }
+
+    b->name = name;
+    b->sym = sym;
+    b->depth = s->depth;
+    b->shadowed = yfh_get(s->names, name);
+    if (yfh_set(s->names, name, b)) {
+        b->shadowed = s->free_bindings;
+        s->free_bindings = b;
+        return 1;
     }
+    s->bindings[s->num_bindings++] = b;
+
+    return 0;
+
 }
 
 int enter_scope(struct yfv_validator * v, struct yfs_symtab ** stuff) {
 
-    struct yfs_symtab * old_symtab, * new_symtab;
-    old_symtab = v->current_scope;
+    struct yfv_scopes * s = &v->scopes;
+    struct yfs_symtab * new_symtab;
+    size_t * newmarks, newcap;
 
-    new_symtab = yf_malloc(sizeof (struct yfs_symtab));
-    if (!new_symtab) {
-        return 1;
+    if ((size_t) s->depth == s->marks_cap) {
+        newcap = s->marks_cap ? s->marks_cap * 2 : 16;
+        newmarks = yf_realloc(s->marks, sizeof (size_t) * newcap);
+        if (!newmarks)
+            return 1;
+        s->marks = newmarks;
+        s->marks_cap = newcap;
     }
-    new_symtab->table = yfh_new();
-    if (!new_symtab->table) {
-        free(new_symtab);
+
+    /* The table is only created once something is declared in the scope. */
+    new_symtab = yfv_alloc(v, sizeof (struct yfs_symtab));
+    if (!new_symtab) {
         return 1;
     }
+    new_symtab->table = NULL;
+    new_symtab->parent = v->current_scope;
 
-    new_symtab->parent = old_symtab;
+    s->marks[s->depth++] = s->num_bindings;
     v->current_scope = new_symtab;
 
     if (stuff)
@@ -88,17 +219,36 @@ int enter_scope(struct yfv_validator * v, struct yfs_symtab ** stuff) {
 }
 
 void exit_scope(struct yfv_validator * v) {
+
+    struct yfv_scopes * s = &v->scopes;
+    struct yfv_binding * b;
+    size_t mark = s->marks[--s->depth];
+
+    /* Pop this scope's bindings, making the shadowed ones visible again. */
+    while (s->num_bindings > mark) {
+        b = s->bindings[--s->num_bindings];
+        yfv_unbind(s, b);
+        b->shadowed = s->free_bindings;
+        s->free_bindings = b;
+    }
+
     /* Don't free scope - used later during codegen */
     v->current_scope = v->current_scope->parent;
+
 }
 
 int yfv_add_type(
     struct yf_compile_analyse_job * udata,
     struct yfs_type * type
 ) {
-    /**
-     * Set a value in the hashmap.
-     */
+    if (!udata->types.table) {
+        if ( (udata->types.table = yfh_new_in(
+            &udata->arena, YFH_DEFAULT_CAPACITY
+        )) == NULL)
+            return 1;
+    }
+    if (yfs_register_type(type))
+        return 1;
     return yfh_set(udata->types.table, type->name, type);
 }
 
@@ -109,15 +259,16 @@ struct yfs_type * yfv_get_type_t(
     /**
      * Get a value from the hashmap.
      */
-    return yfv_get_type_s(udata, type.databuf);
+    return yfv_get_type_s(udata, type.name);
 }
 
 struct yfs_type * yfv_get_type_s(
     struct yf_compile_analyse_job * udata,
-    char * typestr
+    const char * typestr
 ) {
-    /**
-     * Get a value from the hashmap.
-     */
-    return yfh_get(udata->types.table, typestr);
+    /* The unit's own types first, then the builtin ones. */
+    struct yfs_type * type;
+    if (udata->types.table && (type = yfh_get(udata->types.table, typestr)))
+        return type;
+    return yfs_get_builtin_type(typestr);
 }
@@ -31,10 +31,10 @@ int validate_vardecl(
             YF_PRINT_ERROR(
                 "File %s: duplicate declaration of symbol '%s'"
                 ", lines %d and %d",
-                cin->loc.file,
+                yf_loc_file(cin->loc),
                 c->name.name,
-                entry->loc.line,
-                cin->loc.line
+                yf_loc_line(entry->loc),
+                yf_loc_line(cin->loc)
             );
             return 1;
         } else {
@@ -42,30 +42,28 @@ int validate_vardecl(
             YF_PRINT_WARNING(
                 "File %s: global symbol '%s' (line %d) "
                 "shadowed by local symbol (line %d)",
-                cin->loc.file,
+                yf_loc_file(cin->loc),
                 c->name.name,
-                entry->loc.line,
-                cin->loc.line
+                yf_loc_line(entry->loc),
+                yf_loc_line(cin->loc)
             );
         }
     }
 
     /* Construct abstract instance, ONLY if non-global */
 
-    a->name = yf_malloc(sizeof (struct yf_sym));
-    if (!a->name)
-        return 2;
-
-    a->name->type = YFS_VAR;
-
     /* Add to symbol table UNLESS it is global scope. */
     /* The global scope symtab is already set up. */
     if (!global) {
+        a->name = yfv_alloc(validator, sizeof (struct yf_sym));
+        if (!a->name)
+            return 2;
+        a->name->type = YFS_VAR;
         a->name->var.name = c->name.name;
-        yfh_set(validator->current_scope->table, c->name.name, a->name);
+        if (declare_symbol(validator, c->name.name, a->name)) {
+            return 2;
+        }
     } else {
-        /* Free the name, since it was only needed for type checking. */
-        free(a->name);
         /* If it's global, set "name" to point to the global symbol. */
         a->name = entry;
     }
@@ -78,10 +76,10 @@ int validate_vardecl(
     ) == NULL) {
         YF_PRINT_ERROR(
             "%s %d:%d: Unknown type '%s' in declaration of '%s'",
-            cin->loc.file,
-            cin->loc.line,
-            cin->loc.column,
-            c->type.databuf,
+            yf_loc_file(cin->loc),
+            yf_loc_line(cin->loc),
+            yf_loc_column(cin->loc),
+            c->type.name,
             c->name.name
         );
         /**
@@ -98,9 +96,9 @@ int validate_vardecl(
     ) {
         YF_PRINT_ERROR(
             "%s %d:%d: Variable '%s' has type 'void'",
-            cin->loc.file,
-            cin->loc.line,
-            cin->loc.column,
+            yf_loc_file(cin->loc),
+            yf_loc_line(cin->loc),
+            yf_loc_column(cin->loc),
             c->name.name
         );
         return 1;
@@ -109,12 +107,12 @@ int validate_vardecl(
     a->name->loc = cin->loc;
 
     if (c->expr) {
-        a->expr = yf_malloc(sizeof (struct yf_ast_node));
+        a->expr = yfv_alloc(validator, sizeof (struct yf_ast_node));
         if (!a->expr)
             return 2;
         a->expr->type = YFA_EXPR;
         if (validate_expr(validator, c->expr, a->expr)) {
-            free(a->expr);
+            yfv_free(validator, a->expr, sizeof (struct yf_ast_node));
             a->expr = NULL;
             return 1;
         }
@@ -125,7 +123,7 @@ int validate_vardecl(
     /* Check that the types are compatible. */
     if (a->expr) {
         if (yfs_output_diagnostics(
-            yfse_get_expr_type(&a->expr->expr, validator->udata),
+            a->expr->expr.dtype,
             a->name->var.dtype,
             validator->udata,
             &cin->loc
@@ -4,62 +4,30 @@
 #include <semantics/types.h>
 #include <semantics/validate/validate-internal.h>
 
-static void add_type(
-    struct yf_compile_analyse_job * udata,
-    char * name, int size, enum yfpt_format fmt
-) {
-
-    struct yfs_type * type = yf_malloc(sizeof (struct yfs_type));
-    type->primitive.size = size;
-    type->kind = YFST_PRIMITIVE;
-    type->primitive.type = fmt;
-    type->name = name;
-    yfv_add_type(udata, type);
-
-}
-
-static void yfv_add_builtin_types(struct yf_compile_analyse_job * udata) {
-
-    /* All types are signed for now - unsigned types are not yet supported. */
-
-    /* "standard" types. */
-    add_type(udata, "char",        8, YFS_INT  );
-    add_type(udata, "short",      16, YFS_INT  );
-    add_type(udata, "int",        32, YFS_INT  );
-    add_type(udata, "long",       64, YFS_INT  );
-    add_type(udata, "void",        0, YFS_NONE );
-    add_type(udata, "float",      32, YFS_FLOAT);
-    add_type(udata, "double",     64, YFS_FLOAT);
-
-    /* Convenience types. */
-    add_type(udata, "i16",        16, YFS_INT  );
-    add_type(udata, "i32",        32, YFS_INT  );
-    add_type(udata, "i64",        64, YFS_INT  );
-    add_type(udata, "f16",        16, YFS_FLOAT);
-    add_type(udata, "f32",        32, YFS_FLOAT);
-    add_type(udata, "f64",        64, YFS_FLOAT);
-
-    /* We're considering bool to be one bit for conversion purposes. */
-    add_type(udata, "bool",       1,  YFS_INT  );
-
-}
-
 int yfs_validate(
     struct yf_compile_analyse_job * udata,
     struct yf_compilation_data * pdata
 ) {
 
-    udata->types.table = yfh_new();
-    yfv_add_builtin_types(udata);
+    /* Only created once a user-defined type is added - builtin types live in
+    the shared registry. */
+    udata->types.table = NULL;
     struct yfv_validator validator = {
         /* Root symbol table is the global scope of the program. */
         .current_scope = &udata->symtab,
         .udata         = udata,
         .pdata         = pdata
     };
-    return validate_program(
+    int err;
+    if (yfv_scopes_init(&validator)) {
+        yfv_scopes_destroy(&validator);
+        return 2;
+    }
+    err = validate_program(
         &validator, &udata->parse_tree, &udata->ast_tree
     );
+    yfv_scopes_destroy(&validator);
+    return err;
 
 }
 
@@ -110,19 +78,19 @@ int validate_program(
     aprog = &ain->program;
     ain->type = YFA_PROGRAM;
 
-    yf_list_init(&aprog->decls);
+    yf_vector_init_in(&aprog->decls, &validator->udata->arena);
     
     /* Iterate through all decls, construct abstract instances of them, and move
     them into the abstract list. */
-    YF_LIST_FOREACH(cprog->decls, cnode) {
+    YF_VECTOR_FOREACH(cprog->decls, cnode) {
         /* Construct abstract instance */
-        anode = yf_malloc(sizeof (struct yf_ast_node));
+        anode = yfv_alloc(validator, sizeof (struct yf_ast_node));
         if (!anode)
             return 2;
 
         /* Validate */
         if (validate_node(validator, cnode, anode, NULL, NULL)) {
-            yf_free(anode);
+            yfv_free(validator, anode, sizeof (struct yf_ast_node));
             anode = NULL;
             validator->error = 1;
             err = 1;
@@ -131,7 +99,7 @@ int validate_program(
 
         /* Move to abstract list */
         if (anode)
-            yf_list_add(&aprog->decls, anode);
+            yf_vector_push(&aprog->decls, anode);
     }
 
     return err;
@@ -148,12 +116,14 @@ int validate_return(
     struct yfa_return  * a = &ain->ret;
 
     ain->type = YFA_RETURN;
-    a->expr = yf_malloc(sizeof (struct yf_ast_node));
-    if (!a->expr)
-        return 2;
 
     if (c->expr) {
+        a->expr = yfv_alloc(validator, sizeof (struct yf_ast_node));
+        if (!a->expr)
+            return 2;
         if (validate_expr(validator, c->expr, a->expr)) {
+            yfv_free(validator, a->expr, sizeof (struct yf_ast_node));
+            a->expr = NULL;
             validator->error = 1;
             return 1;
         }
@@ -164,8 +134,8 @@ int validate_return(
     if ( (type->primitive.size != 0) ?
             yfs_output_diagnostics(
                 (a->expr != NULL)
-                    ? yfse_get_expr_type(&a->expr->expr, validator->udata)
-                    : yfv_get_type_s(validator->udata, "void"),
+                    ? a->expr->expr.dtype
+                    : YFS_TYPE_VOID,
                 type,
                 validator->udata,
                 &cin->loc
@@ -1,24 +1,332 @@
 #include "allocator.h"
 
-#include <util/yfc-out.h>
+#include <stdatomic.h>
 #include <string.h>
 
+#include <util/yfc-out.h>
+
+/**
+ * Every block starts with this header, padded to keep the data aligned.
+ */
+struct yf_alloc_header {
+    size_t size;
+    enum yf_alloc_tag tag;
+};
+
+#define YF_ALLOC_HEADER_SIZE \
+    ((sizeof (struct yf_alloc_header) + _Alignof (max_align_t) - 1) \
+        & ~(_Alignof (max_align_t) - 1))
+
+#define HEADER(ptr) \
+    ((struct yf_alloc_header *) ((char *) (ptr) - YF_ALLOC_HEADER_SIZE))
+
+/**
+ * The counters are atomic, so that any thread may allocate.
+ */
+static struct {
+    atomic_size_t allocs, bytes, live, peak;
+} stats[YF_ALLOC_NUM_TAGS + 1]; /* Last one is the total */
+
+static atomic_size_t pool_freed, pool_reused;
+
+static _Thread_local enum yf_alloc_tag current_tag = YF_ALLOC_DRIVER;
+
+static void yf_raise_peak(atomic_size_t * peak, size_t live) {
+    size_t old = atomic_load_explicit(peak, memory_order_relaxed);
+    while (old < live && !atomic_compare_exchange_weak_explicit(
+        peak, &old, live, memory_order_relaxed, memory_order_relaxed
+    )) {}
+}
+
+static void yf_count_alloc(enum yf_alloc_tag tag, size_t size) {
+
+    int i, idx[2] = { tag, YF_ALLOC_NUM_TAGS };
+    size_t live;
+
+    for (i = 0; i < 2; ++i) {
+        atomic_fetch_add_explicit(
+            &stats[idx[i]].allocs, 1, memory_order_relaxed
+        );
+        atomic_fetch_add_explicit(
+            &stats[idx[i]].bytes, size, memory_order_relaxed
+        );
+        live = atomic_fetch_add_explicit(
+            &stats[idx[i]].live, size, memory_order_relaxed
+        ) + size;
+        yf_raise_peak(&stats[idx[i]].peak, live);
+    }
+
+}
+
+static void yf_count_free(enum yf_alloc_tag tag, size_t size) {
+    atomic_fetch_sub_explicit(&stats[tag].live, size, memory_order_relaxed);
+    atomic_fetch_sub_explicit(
+        &stats[YF_ALLOC_NUM_TAGS].live, size, memory_order_relaxed
+    );
+}
+
 void * yf_malloc(size_t size) {
 
-    void * ret;
-    ret = malloc(size);
+    struct yf_alloc_header * header;
+    header = malloc(YF_ALLOC_HEADER_SIZE + size);
 
-    if (ret == NULL) {
+    if (header == NULL) {
         YF_PRINT_ERROR("Allocation of %zu bytes failed", size);
+        /* Return anyway, the error will be printed out before. */
+        return NULL;
     }
 
-    /* Return anyway, the error will be printed out before. */
-    return ret;
+    header->size = size;
+    header->tag = current_tag;
+    yf_count_alloc(header->tag, size);
+    return (char *) header + YF_ALLOC_HEADER_SIZE;
+
+}
+
+void * yf_realloc(void * ptr, size_t size) {
+
+    struct yf_alloc_header * header, * ret;
+    size_t old_size;
+
+    if (!ptr)
+        return yf_malloc(size);
+
+    header = HEADER(ptr);
+    old_size = header->size;
+    ret = realloc(header, YF_ALLOC_HEADER_SIZE + size);
+
+    if (ret == NULL) {
+        YF_PRINT_ERROR("Reallocation to %zu bytes failed", size);
+        /* On failure, the old block is still valid and owned by the caller. */
+        return NULL;
+    }
+
+    yf_count_free(ret->tag, old_size);
+    yf_count_alloc(ret->tag, size);
+    ret->size = size;
+    return (char *) ret + YF_ALLOC_HEADER_SIZE;
 
 }
 
 void yf_free(void * ptr) {
-    free(ptr);
+
+    struct yf_alloc_header * header;
+
+    if (!ptr)
+        return;
+
+    header = HEADER(ptr);
+    yf_count_free(header->tag, header->size);
+    free(header);
+
+}
+
+enum yf_alloc_tag yf_set_alloc_tag(enum yf_alloc_tag tag) {
+    enum yf_alloc_tag prev = current_tag;
+    current_tag = tag;
+    return prev;
+}
+
+const char * yf_alloc_tag_name(enum yf_alloc_tag tag) {
+    static const char * names[] = {
+        [YF_ALLOC_DRIVER]   = "driver",
+        [YF_ALLOC_LEXER]    = "lexer",
+        [YF_ALLOC_PARSER]   = "parser",
+        [YF_ALLOC_SYMTAB]   = "symtab",
+        [YF_ALLOC_VALIDATE] = "validate",
+        [YF_ALLOC_GEN]      = "gen",
+        [YF_ALLOC_ARENA]    = "arena overhead",
+        [YF_ALLOC_NUM_TAGS] = "total",
+    };
+    return names[tag];
+}
+
+void yf_get_alloc_stats(enum yf_alloc_tag tag, struct yf_alloc_stats * out) {
+    out->allocs = atomic_load_explicit(&stats[tag].allocs, memory_order_relaxed);
+    out->bytes  = atomic_load_explicit(&stats[tag].bytes, memory_order_relaxed);
+    out->live   = atomic_load_explicit(&stats[tag].live, memory_order_relaxed);
+    out->peak   = atomic_load_explicit(&stats[tag].peak, memory_order_relaxed);
+}
+
+void yf_get_pool_stats(struct yf_pool_stats * out) {
+    out->freed  = atomic_load_explicit(&pool_freed, memory_order_relaxed);
+    out->reused = atomic_load_explicit(&pool_reused, memory_order_relaxed);
+}
+
+/**
+ * Chunks are this large unless a single allocation needs more.
+ */
+#define YF_ARENA_CHUNK_SIZE 65536
+
+/**
+ * Everything handed out is aligned to this.
+ */
+#define YF_ARENA_ALIGN (_Alignof (max_align_t))
+
+struct yf_arena_chunk {
+    struct yf_arena_chunk * next;
+};
+
+/* Blocks in a free list are linked through their first bytes. */
+struct yf_arena_free_block {
+    struct yf_arena_free_block * next;
+};
+
+/* The chunk header is padded so that the data after it stays aligned. */
+#define YF_ARENA_HEADER_SIZE \
+    ((sizeof (struct yf_arena_chunk) + YF_ARENA_ALIGN - 1) \
+        & ~(YF_ARENA_ALIGN - 1))
+
+/**
+ * The size class of an allocation, or -1 if it's too large for one. The size
+ * must already be rounded up to the alignment.
+ */
+static int yf_arena_class(size_t size) {
+    size_t cls = size / YF_ARENA_ALIGN - 1;
+    return cls < YF_ARENA_NUM_CLASSES ? (int) cls : -1;
+}
+
+/**
+ * Move an arena allocation's bytes from the arena's overhead to the current
+ * tag. The total stays the same, since the chunk was counted when it was
+ * allocated.
+ */
+static void yf_count_arena_alloc(struct yf_arena * arena, size_t size) {
+
+    enum yf_alloc_tag tag = current_tag;
+    size_t live;
+
+    atomic_fetch_add_explicit(&stats[tag].allocs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&stats[tag].bytes, size, memory_order_relaxed);
+    live = atomic_fetch_add_explicit(
+        &stats[tag].live, size, memory_order_relaxed
+    ) + size;
+    yf_raise_peak(&stats[tag].peak, live);
+    atomic_fetch_sub_explicit(
+        &stats[YF_ALLOC_ARENA].live, size, memory_order_relaxed
+    );
+    arena->live[tag] += size;
+
+}
+
+/**
+ * Move bytes from a tag back to the arena's overhead. The per-arena count may
+ * wrap if a block is freed under a different tag than it was allocated under,
+ * but it still adds up to what the tag was charged.
+ */
+static void yf_count_arena_free(
+    struct yf_arena * arena, enum yf_alloc_tag tag, size_t size
+) {
+    atomic_fetch_sub_explicit(&stats[tag].live, size, memory_order_relaxed);
+    atomic_fetch_add_explicit(
+        &stats[YF_ALLOC_ARENA].live, size, memory_order_relaxed
+    );
+    arena->live[tag] -= size;
+}
+
+void yf_arena_init(struct yf_arena * arena) {
+    memset(arena, 0, sizeof (struct yf_arena));
+}
+
+void * yf_arena_alloc(struct yf_arena * arena, size_t size) {
+
+    struct yf_arena_chunk * chunk;
+    struct yf_arena_free_block * block;
+    enum yf_alloc_tag prev_tag;
+    size_t chunk_size;
+    void * ret;
+    int cls;
+
+    size = (size + YF_ARENA_ALIGN - 1) & ~(YF_ARENA_ALIGN - 1);
+    if (size == 0)
+        size = YF_ARENA_ALIGN;
+
+    /* Reuse a discarded block of the same size class if there is one. */
+    cls = yf_arena_class(size);
+    if (cls != -1 && (block = arena->free_lists[cls]) != NULL) {
+        arena->free_lists[cls] = block->next;
+        atomic_fetch_add_explicit(&pool_reused, 1, memory_order_relaxed);
+        yf_count_arena_alloc(arena, size);
+        return block;
+    }
+
+    if ((size_t) (arena->end - arena->cur) < size) {
+        chunk_size = YF_ARENA_HEADER_SIZE + size;
+        if (chunk_size < YF_ARENA_CHUNK_SIZE)
+            chunk_size = YF_ARENA_CHUNK_SIZE;
+        prev_tag = yf_set_alloc_tag(YF_ALLOC_ARENA);
+        chunk = yf_malloc(chunk_size);
+        yf_set_alloc_tag(prev_tag);
+        if (!chunk)
+            return NULL;
+        chunk->next = arena->chunks;
+        arena->chunks = chunk;
+        arena->cur = (char *) chunk + YF_ARENA_HEADER_SIZE;
+        arena->end = (char *) chunk + chunk_size;
+    }
+
+    ret = arena->cur;
+    arena->cur += size;
+    yf_count_arena_alloc(arena, size);
+    return ret;
+
+}
+
+void * yf_arena_realloc(
+    struct yf_arena * arena, void * ptr, size_t old_size, size_t size
+) {
+
+    void * ret;
+
+    if (size <= old_size)
+        return ptr;
+
+    ret = yf_arena_alloc(arena, size);
+    if (ret && ptr) {
+        memcpy(ret, ptr, old_size);
+        yf_arena_free(arena, ptr, old_size);
+    }
+    return ret;
+
+}
+
+void yf_arena_free(struct yf_arena * arena, void * ptr, size_t size) {
+
+    struct yf_arena_free_block * block = ptr;
+    int cls;
+
+    if (!ptr)
+        return;
+
+    size = (size + YF_ARENA_ALIGN - 1) & ~(YF_ARENA_ALIGN - 1);
+    if (size == 0)
+        size = YF_ARENA_ALIGN;
+
+    /* Even a block too large to reuse is no longer the caller's. */
+    yf_count_arena_free(arena, current_tag, size);
+    if ( (cls = yf_arena_class(size)) == -1)
+        return;
+
+    block->next = arena->free_lists[cls];
+    arena->free_lists[cls] = block;
+    atomic_fetch_add_explicit(&pool_freed, 1, memory_order_relaxed);
+
+}
+
+void yf_arena_destroy(struct yf_arena * arena) {
+
+    struct yf_arena_chunk * chunk, * next;
+    int tag;
+
+    for (tag = 0; tag < YF_ALLOC_NUM_TAGS; ++tag)
+        yf_count_arena_free(arena, tag, arena->live[tag]);
+    for (chunk = arena->chunks; chunk; chunk = next) {
+        next = chunk->next;
+        yf_free(chunk);
+    }
+
+    yf_arena_init(arena);
+
 }
 
 /**
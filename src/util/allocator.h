@@ -1,7 +1,6 @@
 /**
- * An allocator. Mostly a wrapper around malloc for now, but may be more
- * complicated later. This mostly exists for the purpose of printing out
- * errors.
+ * An allocator. A wrapper around malloc that prints out errors, and keeps track
+ * of how much memory each part of the compiler uses.
  */
 
 #ifndef UTIL_ALLOCATOR_H
@@ -10,9 +9,121 @@
 #include <stddef.h>
 #include <stdlib.h>
 
+/**
+ * Memory from these MUST only be released with yf_free/yf_realloc, and memory
+ * from plain malloc must never be passed to them - every block carries a small
+ * header used for accounting.
+ */
 void * yf_malloc(size_t size);
+void * yf_realloc(void * ptr, size_t size);
 void yf_free(void * ptr);
 
+/**
+ * The part of the compiler that an allocation is charged to.
+ */
+enum yf_alloc_tag {
+    YF_ALLOC_DRIVER,
+    YF_ALLOC_LEXER,
+    YF_ALLOC_PARSER,
+    YF_ALLOC_SYMTAB,
+    YF_ALLOC_VALIDATE,
+    YF_ALLOC_GEN,
+    YF_ALLOC_ARENA, /* The parts of arena chunks not handed out - not to be set */
+    YF_ALLOC_NUM_TAGS
+};
+
+/**
+ * Charge the following allocations made by this thread to a tag. Returns the
+ * previous tag, so that it can be restored. Frees and reallocations are always
+ * charged to the tag the block was allocated under.
+ * Arena chunks are charged to YF_ALLOC_ARENA, and each allocation from an
+ * arena then moves its bytes from there to the current tag. yf_arena_free,
+ * which can't tell what a block was allocated under, moves them back from the
+ * current tag.
+ */
+enum yf_alloc_tag yf_set_alloc_tag(enum yf_alloc_tag tag);
+
+const char * yf_alloc_tag_name(enum yf_alloc_tag tag);
+
+struct yf_alloc_stats {
+    size_t allocs; /* Number of allocations */
+    size_t bytes; /* Total bytes ever allocated */
+    size_t live; /* Bytes currently allocated */
+    size_t peak; /* High-water mark of "live" */
+};
+
+/**
+ * Get the statistics of a tag, or of all tags together if tag is
+ * YF_ALLOC_NUM_TAGS. The total peak is the peak of the total, not the sum of
+ * the peaks. The total only counts memory taken from malloc, so an arena
+ * chunk counts once, not again for each allocation carved out of it.
+ */
+void yf_get_alloc_stats(enum yf_alloc_tag tag, struct yf_alloc_stats * stats);
+
+struct yf_pool_stats {
+    size_t freed; /* Blocks given back to an arena's free lists */
+    size_t reused; /* Arena allocations served from a free list */
+};
+
+/**
+ * Get the statistics of the arena free lists, over all arenas.
+ */
+void yf_get_pool_stats(struct yf_pool_stats * stats);
+
+/**
+ * Small blocks given back to an arena are kept in a free list per size class,
+ * in steps of 16 bytes up to this many steps.
+ */
+#define YF_ARENA_NUM_CLASSES 32
+
+/**
+ * A region allocator. Allocations are bumped out of large chunks, and
+ * everything is released at once when the arena is destroyed. Each compilation
+ * unit owns one, for its trees and symbols.
+ * Small blocks that are discarded early (nodes thrown away on an error path,
+ * outgrown vector storage) can be given back with yf_arena_free, and are then
+ * reused by the next allocation of the same size class.
+ * An arena that is all zeroes is valid and empty.
+ */
+struct yf_arena {
+    struct yf_arena_chunk * chunks;
+    char * cur, * end;
+    void * free_lists[YF_ARENA_NUM_CLASSES];
+    /* Bytes charged to each tag, given back when the arena is destroyed */
+    size_t live[YF_ALLOC_NUM_TAGS];
+};
+
+/**
+ * Set up an empty arena. Nothing is allocated until the first allocation.
+ */
+void yf_arena_init(struct yf_arena * arena);
+
+/**
+ * Allocate memory, aligned for any type, that lives until the arena is
+ * destroyed. Returns NULL (and prints an error) on failure.
+ */
+void * yf_arena_alloc(struct yf_arena * arena, size_t size);
+
+/**
+ * Give a block back to the arena for reuse. size must be the size it was
+ * allocated with. Blocks too large for a size class are only reclaimed when
+ * the arena is destroyed.
+ */
+void yf_arena_free(struct yf_arena * arena, void * ptr, size_t size);
+
+/**
+ * Resize an allocation made from the arena. The old contents are copied to a
+ * new block, and the old block is given back to the arena.
+ */
+void * yf_arena_realloc(
+    struct yf_arena * arena, void * ptr, size_t old_size, size_t size
+);
+
+/**
+ * Release all memory allocated from the arena. The arena is empty afterwards.
+ */
+void yf_arena_destroy(struct yf_arena * arena);
+
 /**
  * A version of strcpy that returns pointer to the terminating NUL-byte for faster concatenations
  */
@@ -3,95 +3,221 @@
 #include <string.h>
 
 #include <util/allocator.h>
+#include <util/intern.h>
 
-#define MAX_STEPS 10
+static void * yfh_alloc(struct yf_arena * arena, size_t size) {
+    return arena ? yf_arena_alloc(arena, size) : yf_malloc(size);
+}
+
+static void yfh_release(struct yf_arena * arena, void * ptr) {
+    if (!arena)
+        yf_free(ptr);
+}
+
+/**
+ * Allocate a zeroed bucket table. num_buckets must be a power of two.
+ */
+static unsigned * yfh_alloc_buckets(
+    struct yf_arena * arena, size_t num_buckets
+) {
+    unsigned * buckets;
+    buckets = yfh_alloc(arena, sizeof (unsigned) * num_buckets);
+    if (buckets)
+        memset(buckets, 0, sizeof (unsigned) * num_buckets);
+    return buckets;
+}
+
+struct yf_hashmap * yfh_new(void) {
+    return yfh_new_in(NULL, YFH_DEFAULT_CAPACITY);
+}
+
+struct yf_hashmap * yfh_new_sized(size_t capacity) {
+    return yfh_new_in(NULL, capacity);
+}
+
+struct yf_hashmap * yfh_new_in(struct yf_arena * arena, size_t capacity) {
 
-struct yf_hashmap * yfh_new() {
     struct yf_hashmap * hm;
-    hm = yf_malloc(sizeof (struct yf_hashmap));
-    memset(hm, 0, sizeof (struct yf_hashmap));
-    hm->buckets = yf_malloc(sizeof (struct yfh_bucket) * YFH_BUCKETS);
-    memset(hm->buckets, 0, sizeof (struct yfh_bucket) * YFH_BUCKETS);
+    size_t num_buckets;
+
+    /* Round up so that "capacity" entries fit under the 3/4 load factor. */
+    num_buckets = YFH_DEFAULT_CAPACITY;
+    while (num_buckets * 3 / 4 < capacity)
+        num_buckets *= 2;
+
+    hm = yfh_alloc(arena, sizeof (struct yf_hashmap));
+    if (!hm)
+        return NULL;
+    hm->arena = arena;
+    hm->num_buckets = num_buckets;
+    hm->num_entries = 0;
+    hm->entries_capacity = num_buckets * 3 / 4;
+    hm->buckets = yfh_alloc_buckets(arena, num_buckets);
+    hm->entries = yfh_alloc(
+        arena, sizeof (struct yfh_entry) * hm->entries_capacity
+    );
+    if (!hm->buckets || !hm->entries) {
+        yfh_release(arena, hm->buckets);
+        yfh_release(arena, hm->entries);
+        yfh_release(arena, hm);
+        return NULL;
+    }
     return hm;
+
 }
 
 void yfh_destroy(struct yf_hashmap * hm, int (*cleanup)(void *)) {
 
-    int index;
+    struct yfh_entry * entry;
 
     if (cleanup) {
-        for (index = 0; index < YFH_BUCKETS; ++index) {
-            if (hm->buckets[index].value)
-                cleanup(hm->buckets[index].value);
+        YFH_FOREACH(hm, entry) {
+            if (entry->value)
+                cleanup(entry->value);
         }
     }
 
-    free(hm->buckets);
-    free(hm);
+    yfh_release(hm->arena, hm->entries);
+    yfh_release(hm->arena, hm->buckets);
+    yfh_release(hm->arena, hm);
 
 }
 
-static unsigned long hash(const char * key);
-
-int yfh_set(struct yf_hashmap * hm, const char * key, void * value) {
-
-    unsigned loc, newloc;
-    int i;
-
-    loc = hash(key) % YFH_BUCKETS;
+/**
+ * Find the bucket that refers to the key, or the empty bucket where it would
+ * be inserted. Since the table is never full, this always terminates.
+ */
+static unsigned * yfh_find_bucket(
+    const struct yf_hashmap * hm, const char * key, unsigned long h
+) {
+
+    size_t mask = hm->num_buckets - 1;
+    size_t loc = h & mask;
+    unsigned * b;
+    struct yfh_entry * e;
+
+    for (;; loc = (loc + 1) & mask) {
+        b = &hm->buckets[loc];
+        if (*b == 0)
+            return b;
+        e = &hm->entries[*b - 1];
+        if (e->key == key)
+            return b;
+    }
 
-    const char * pkey;
+}
 
-    /* Traverse forward until we find it. */
-    for (i = 0; i < 10; ++loc, ++i) {
-        newloc = (loc + i) % YFH_BUCKETS;
-        pkey = hm->buckets[newloc].key;
-        if (pkey && !strcmp(key, pkey)) {
-            hm->buckets[newloc].value = value;
-            return 0;
-        }
-        if (hm->buckets[newloc].key == NULL) {
-            hm->buckets[newloc].value = value;
-            hm->buckets[newloc].key   = key;
-            return 0;
-        }
+/**
+ * Double the number of buckets and re-point them at the existing entries.
+ * The entries themselves don't move, so insertion order is kept.
+ */
+static int yfh_grow(struct yf_hashmap * hm) {
+
+    unsigned * new_buckets;
+    struct yfh_entry * new_entries;
+    size_t new_num, i, mask, loc;
+
+    new_num = hm->num_buckets * 2;
+    new_buckets = yfh_alloc_buckets(hm->arena, new_num);
+    if (!new_buckets)
+        return 1;
+
+    if (hm->arena) {
+        new_entries = yf_arena_realloc(
+            hm->arena, hm->entries,
+            sizeof (struct yfh_entry) * hm->entries_capacity,
+            sizeof (struct yfh_entry) * (new_num * 3 / 4)
+        );
+    } else {
+        new_entries = yf_realloc(
+            hm->entries, sizeof (struct yfh_entry) * (new_num * 3 / 4)
+        );
+    }
+    if (!new_entries) {
+        yfh_release(hm->arena, new_buckets);
+        return 1;
+    }
+    hm->entries = new_entries;
+    hm->entries_capacity = new_num * 3 / 4;
+
+    /* Every key is already unique, so just find the first empty bucket. */
+    mask = new_num - 1;
+    for (i = 0; i < hm->num_entries; ++i) {
+        for (loc = hm->entries[i].hash & mask; new_buckets[loc];
+            loc = (loc + 1) & mask) {}
+        new_buckets[loc] = i + 1;
     }
 
-    return 1;
+    yfh_release(hm->arena, hm->buckets);
+    hm->buckets = new_buckets;
+    hm->num_buckets = new_num;
+    return 0;
 
 }
 
-void * yfh_get(struct yf_hashmap * hm, char * key) {
-    
-    unsigned loc, newloc;
-    int i;
+int yfh_set(struct yf_hashmap * hm, const char * key, void * value) {
 
-    loc = hash(key) % YFH_BUCKETS;
+    unsigned long h = yf_intern_hash(key);
+    unsigned * b;
+    struct yfh_entry * e;
 
-    const char * pkey;
+    b = yfh_find_bucket(hm, key, h);
+    if (*b) {
+        hm->entries[*b - 1].value = value;
+        return 0;
+    }
 
-    /* Traverse forward until we find it. */
-    for (i = 0; i < 10; ++loc, ++i) {
-        newloc = (loc + i) % YFH_BUCKETS;
-        pkey = hm->buckets[newloc].key;
-        if (pkey && !strcmp(key, pkey)) {
-            return hm->buckets[newloc].value;
-        }
+    /* A new key - make room first if this would go over the load factor. */
+    if (hm->num_entries == hm->entries_capacity) {
+        if (yfh_grow(hm))
+            return 1;
+        b = yfh_find_bucket(hm, key, h);
     }
 
-    return NULL;
+    e = &hm->entries[hm->num_entries++];
+    e->key   = key;
+    e->value = value;
+    e->hash  = h;
+    *b = hm->num_entries;
+    return 0;
 
 }
 
-/* Credit - djb2 */
-static unsigned long hash(const char * key) {
-
-    unsigned long hash = 5381;
-    int c;
+void * yfh_get(struct yf_hashmap * hm, const char * key) {
+    unsigned * b = yfh_find_bucket(hm, key, yf_intern_hash(key));
+    return *b ? hm->entries[*b - 1].value : NULL;
+}
 
-    while ((c = *key++))
-        hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+void yfh_remove(struct yf_hashmap * hm, const char * key) {
+
+    size_t mask = hm->num_buckets - 1;
+    size_t hole, loc, home, index;
+    unsigned * b;
+    struct yfh_entry * last;
+
+    b = yfh_find_bucket(hm, key, yf_intern_hash(key));
+    if (*b == 0)
+        return;
+    index = *b - 1;
+
+    /* Empty the bucket, then pull back any later bucket in the same probe
+    run whose home is at or before the hole, so no probe stops short. */
+    hole = b - hm->buckets;
+    hm->buckets[hole] = 0;
+    for (loc = (hole + 1) & mask; hm->buckets[loc]; loc = (loc + 1) & mask) {
+        home = hm->entries[hm->buckets[loc] - 1].hash & mask;
+        if (((loc - home) & mask) >= ((loc - hole) & mask)) {
+            hm->buckets[hole] = hm->buckets[loc];
+            hm->buckets[loc] = 0;
+            hole = loc;
+        }
+    }
 
-    return hash;
+    /* Keep the entries compact by moving the last one into the gap. */
+    last = &hm->entries[--hm->num_entries];
+    if (index != hm->num_entries) {
+        *yfh_find_bucket(hm, last->key, last->hash) = index + 1;
+        hm->entries[index] = *last;
+    }
 
 }
@@ -7,31 +7,65 @@
 #define UTIL_HASHMAP_H
 
 #include <stdbool.h>
+#include <stddef.h>
+
+#include <util/allocator.h>
 
 /**
- * Perhaps larger in the future
+ * The number of buckets a hashmap starts out with if no capacity hint is
+ * given. Most maps (block scopes, parameter lists) hold only a handful of
+ * entries, so this is deliberately small - the map grows as needed.
  */
-#define YFH_BUCKETS 100000
+#define YFH_DEFAULT_CAPACITY 16
 
 /**
  * A hashmap, with string keys and void pointers as values. Values may NOT be
- * NULL, as this indicates an empty value bucket.
+ * NULL, as this is what a lookup of a missing key returns.
+ *
+ * Keys MUST be interned strings (see util/intern.h) - the hash stored with the
+ * interned string is used directly, and keys are compared by pointer.
  *
- * A bunch of buckets with values. Buckets also store the key so that collisions
- * can be avoided, by simply moving the value to be inserted into the next free
- * bucket.
+ * Entries (key, value and the key's hash) are kept in a compact array in the
+ * order they were first inserted, which is what iteration walks. Lookups go
+ * through a separate open-addressing table of buckets, each of which holds
+ * the index of an entry plus one (zero means empty). Collisions are resolved
+ * by probing forward to the next bucket. The number of buckets is always a
+ * power of two, and the bucket table is doubled whenever it becomes more than
+ * 3/4 full, so probe sequences stay short and always end at an empty bucket.
  */
 struct yf_hashmap {
 
-    struct yfh_bucket {
+    struct yfh_entry {
         const char * key;
         void * value;
-    } * buckets;
+        unsigned long hash;
+    } * entries;
+
+    size_t num_entries;
+    size_t entries_capacity;
+
+    unsigned * buckets;
+    size_t num_buckets; /* Always a power of two */
+
+    /* Where the map's memory comes from, NULL for the heap */
+    struct yf_arena * arena;
 
 };
 
 /* Create a new hashmap and return a pointer to it. */
-struct yf_hashmap * yfh_new();
+struct yf_hashmap * yfh_new(void);
+
+/**
+ * Create a new hashmap that can hold at least "capacity" entries before it
+ * needs to grow.
+ */
+struct yf_hashmap * yfh_new_sized(size_t capacity);
+
+/**
+ * Create a new hashmap whose memory is allocated from an arena. Destroying it
+ * is only needed to run a cleanup hook - the memory goes with the arena.
+ */
+struct yf_hashmap * yfh_new_in(struct yf_arena * arena, size_t capacity);
 
 /**
  * Destroy a hashmap.
@@ -48,6 +82,30 @@ int yfh_set(struct yf_hashmap *, const char * key, void * value);
 /**
  * Returns NULL if no key is set.
  */
-void * yfh_get(struct yf_hashmap *, char * key);
+void * yfh_get(struct yf_hashmap *, const char * key);
+
+/**
+ * Remove a key, if it is set. The last entry takes the removed one's place in
+ * iteration order, so removing the newest entries first keeps the order of the
+ * rest.
+ */
+void yfh_remove(struct yf_hashmap *, const char * key);
+
+/**
+ * The number of entries in the hashmap.
+ */
+static inline size_t yfh_size(const struct yf_hashmap * hm) {
+    return hm->num_entries;
+}
+
+/**
+ * Iterate over all entries, in insertion order. The entry's value may be
+ * replaced during iteration, but no keys may be added or removed.
+ * @param hm a pointer to the hashmap, safe to evaluate multiple times
+ * @param entry an lvalue of type struct yfh_entry *
+ */
+#define YFH_FOREACH(hm, entry) \
+    for ((entry) = (hm)->entries; \
+        (entry) != (hm)->entries + (hm)->num_entries; ++(entry))
 
 #endif /* UTIL_HASHMAP_H */
@@ -0,0 +1,237 @@
+#include "intern.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#include <util/allocator.h>
+
+/**
+ * Interned strings are packed into large chunks, each string preceded by its
+ * header and padded so that the next header is aligned. Strings too large to
+ * share a chunk get a chunk of their own.
+ */
+#define YFI_CHUNK_SIZE 65536
+
+struct yfi_chunk {
+    struct yfi_chunk * next;
+};
+
+/**
+ * A string in a thread's own pool has room for its global copy in front of
+ * its header.
+ */
+struct yfi_local_prefix {
+    const char * global;
+    unsigned long pad;
+};
+
+_Static_assert(
+    sizeof (struct yfi_local_prefix) == sizeof (struct yf_intern_header),
+    "the prefix must keep the header aligned"
+);
+
+/**
+ * The pool itself - an open-addressing table of interned strings, plus the
+ * chunks they live in (see struct yf_intern_local, which is the same thing
+ * without the lock).
+ */
+static struct yf_intern_local pool;
+
+/* The lexer may run on a thread of its own, interning while the parser does. */
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Credit - djb2 */
+static unsigned long hash(const char * str, size_t len) {
+
+    unsigned long hash = 5381;
+    size_t i;
+
+    for (i = 0; i < len; ++i)
+        hash = ((hash << 5) + hash) + (unsigned char) str[i]; /* hash * 33 + c */
+
+    return hash;
+
+}
+
+static int yfi_grow(struct yf_intern_local * p) {
+
+    const char ** new_slots;
+    size_t new_num, i, mask, loc;
+
+    new_num = p->num_slots ? p->num_slots * 2 : 1024;
+    new_slots = yf_malloc(sizeof (const char *) * new_num);
+    if (!new_slots)
+        return 1;
+    memset(new_slots, 0, sizeof (const char *) * new_num);
+
+    mask = new_num - 1;
+    for (i = 0; i < p->num_slots; ++i) {
+        if (!p->slots[i])
+            continue;
+        for (loc = yf_intern_hash(p->slots[i]) & mask; new_slots[loc];
+            loc = (loc + 1) & mask) {}
+        new_slots[loc] = p->slots[i];
+    }
+
+    yf_free(p->slots);
+    p->slots = new_slots;
+    p->num_slots = new_num;
+    return 0;
+
+}
+
+/**
+ * Copy a string into chunk storage, with its header in front, and "prefix"
+ * more bytes in front of that.
+ */
+static const char * yfi_store(
+    struct yf_intern_local * p, const char * str, size_t len, unsigned long h,
+    size_t prefix
+) {
+
+    struct yfi_chunk * chunk;
+    struct yf_intern_header * header;
+    size_t need, chunk_size;
+    char * data;
+
+    /* Header, string, NUL-byte, padded to keep the next header aligned. */
+    need = prefix + sizeof (struct yf_intern_header) + len + 1;
+    need = (need + sizeof (struct yf_intern_header) - 1)
+        & ~(sizeof (struct yf_intern_header) - 1);
+
+    if ((size_t) (p->end - p->cur) < need) {
+        chunk_size = sizeof (struct yf_intern_header) + need;
+        if (chunk_size < YFI_CHUNK_SIZE)
+            chunk_size = YFI_CHUNK_SIZE;
+        chunk = yf_malloc(chunk_size);
+        if (!chunk)
+            return NULL;
+        chunk->next = p->chunks;
+        p->chunks = chunk;
+        /* Start the data after a full header's worth of space, so the chunk
+        link doesn't break alignment. */
+        p->cur = (char *) chunk + sizeof (struct yf_intern_header);
+        p->end = (char *) chunk + chunk_size;
+    }
+
+    if (prefix)
+        ((struct yfi_local_prefix *) p->cur)->global = NULL;
+    header = (struct yf_intern_header *) (p->cur + prefix);
+    header->hash = h;
+    header->len = len;
+    data = (char *) (header + 1);
+    memcpy(data, str, len);
+    data[len] = '\0';
+    p->cur += need;
+    return data;
+
+}
+
+/**
+ * Find or add a string in a pool, given its hash. Return NULL if memory
+ * allocation failed.
+ */
+static const char * yfi_intern(
+    struct yf_intern_local * p, const char * str, size_t len, unsigned long h,
+    size_t prefix
+) {
+
+    size_t mask, loc;
+    const char * s;
+
+    if ((p->count + 1) * 4 > p->num_slots * 3) {
+        if (yfi_grow(p))
+            return NULL;
+    }
+
+    mask = p->num_slots - 1;
+    for (loc = h & mask; (s = p->slots[loc]) != NULL; loc = (loc + 1) & mask) {
+        if (yf_intern_hash(s) == h && yf_intern_len(s) == len
+            && !memcmp(s, str, len))
+            return s;
+    }
+
+    if ((s = yfi_store(p, str, len, h, prefix)) != NULL) {
+        p->slots[loc] = s;
+        ++p->count;
+    }
+    return s;
+
+}
+
+static void yfi_free(struct yf_intern_local * p) {
+
+    struct yfi_chunk * chunk, * next;
+
+    for (chunk = p->chunks; chunk; chunk = next) {
+        next = chunk->next;
+        yf_free(chunk);
+    }
+
+    yf_free(p->slots);
+    memset(p, 0, sizeof *p);
+
+}
+
+const char * yf_intern(const char * str) {
+    return yf_intern_n(str, strlen(str));
+}
+
+const char * yf_intern_n(const char * str, size_t len) {
+
+    unsigned long h = hash(str, len);
+    const char * s;
+
+    pthread_mutex_lock(&pool_lock);
+    s = yfi_intern(&pool, str, len, h, 0);
+    pthread_mutex_unlock(&pool_lock);
+    return s;
+
+}
+
+const char * yf_intern_local_n(
+    struct yf_intern_local * local, const char * str, size_t len
+) {
+    return yfi_intern(
+        local, str, len, hash(str, len), sizeof (struct yfi_local_prefix)
+    );
+}
+
+int yf_intern_publish(struct yf_intern_local * local) {
+
+    struct yfi_local_prefix * prefix;
+    const char * s;
+    size_t i;
+    int ret = 0;
+
+    pthread_mutex_lock(&pool_lock);
+    for (i = 0; i < local->num_slots; ++i) {
+        if ( (s = local->slots[i]) == NULL)
+            continue;
+        prefix = (struct yfi_local_prefix *) s - 2;
+        if (prefix->global)
+            continue;
+        prefix->global = yfi_intern(
+            &pool, s, yf_intern_len(s), yf_intern_hash(s), 0
+        );
+        if (!prefix->global) {
+            ret = 1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&pool_lock);
+    return ret;
+
+}
+
+const char * yf_intern_global(const char * lstr) {
+    return ((const struct yfi_local_prefix *) lstr - 2)->global;
+}
+
+void yf_intern_local_free(struct yf_intern_local * local) {
+    yfi_free(local);
+}
+
+void yf_intern_cleanup(void) {
+    yfi_free(&pool);
+}
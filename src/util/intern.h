@@ -0,0 +1,85 @@
+/**
+ * A process-wide string interning pool. Identifiers, type names and module
+ * prefixes are interned once (mostly by the lexer) and from then on passed
+ * around as handles, so they can be compared with == instead of strcmp.
+ */
+
+#ifndef UTIL_INTERN_H
+#define UTIL_INTERN_H
+
+#include <stddef.h>
+
+/**
+ * Get the interned copy of a string. The returned pointer is a normal
+ * NUL-terminated string, stays valid until yf_intern_cleanup is called, and is
+ * the same pointer for every string with the same contents. Safe to call from
+ * several threads at once.
+ * Returns NULL if memory allocation failed.
+ */
+const char * yf_intern(const char * str);
+
+/**
+ * Same as yf_intern, but for the first "len" characters of str, which need
+ * not be NUL-terminated.
+ */
+const char * yf_intern_n(const char * str, size_t len);
+
+/**
+ * Interned strings carry their hash and length in front of them, so neither
+ * needs to be recomputed. These must ONLY be called on interned strings.
+ */
+struct yf_intern_header {
+    unsigned long hash;
+    size_t len;
+};
+
+static inline unsigned long yf_intern_hash(const char * istr) {
+    return ((const struct yf_intern_header *) istr - 1)->hash;
+}
+
+static inline size_t yf_intern_len(const char * istr) {
+    return ((const struct yf_intern_header *) istr - 1)->len;
+}
+
+/**
+ * A pool of strings for one thread alone, interned without taking the lock -
+ * for a lexer thread, so that several of them don't keep waiting on each
+ * other. Its strings work with yf_intern_hash and yf_intern_len, but are NOT
+ * the same pointers as the global ones until mapped with yf_intern_global.
+ * A zeroed struct is an empty pool.
+ */
+struct yf_intern_local {
+    const char ** slots;
+    size_t num_slots;
+    size_t count;
+    struct yfi_chunk * chunks;
+    char * cur, * end;
+};
+
+/**
+ * Same as yf_intern_n, but into a thread's own pool.
+ */
+const char * yf_intern_local_n(
+    struct yf_intern_local * local, const char * str, size_t len
+);
+
+/**
+ * Intern every string of a thread's own pool globally, taking the lock just
+ * once. Strings added to it afterwards need publishing again.
+ * Returns 1 if memory allocation failed.
+ */
+int yf_intern_publish(struct yf_intern_local * local);
+
+/**
+ * Get the global copy of a published string from a thread's own pool.
+ */
+const char * yf_intern_global(const char * lstr);
+
+void yf_intern_local_free(struct yf_intern_local * local);
+
+/**
+ * Release every interned string. All handles are invalid afterwards.
+ */
+void yf_intern_cleanup(void);
+
+#endif /* UTIL_INTERN_H */
@@ -0,0 +1,85 @@
+#include "vector.h"
+
+#include <string.h>
+
+#include <util/allocator.h>
+
+void yf_vector_init(struct yf_vector * vec) {
+    yf_vector_init_in(vec, NULL);
+}
+
+void yf_vector_init_in(struct yf_vector * vec, struct yf_arena * arena) {
+    vec->data = NULL;
+    vec->len = 0;
+    vec->cap = 0;
+    vec->arena = arena;
+}
+
+int yf_vector_reserve(struct yf_vector * vec, size_t cap) {
+
+    void ** data;
+
+    if (cap <= vec->cap)
+        return 0;
+
+    if (vec->arena) {
+        data = yf_arena_realloc(
+            vec->arena, vec->data,
+            sizeof (void *) * vec->cap, sizeof (void *) * cap
+        );
+    } else {
+        data = yf_realloc(vec->data, sizeof (void *) * cap);
+    }
+    if (!data)
+        return -1;
+
+    vec->data = data;
+    vec->cap = cap;
+    return 0;
+
+}
+
+int yf_vector_push(struct yf_vector * vec, void * element) {
+
+    if (vec->len == vec->cap) {
+        if (yf_vector_reserve(vec, vec->cap ? vec->cap * 2 : 8))
+            return -1;
+    }
+
+    vec->data[vec->len++] = element;
+    return 0;
+
+}
+
+int yf_vector_merge(struct yf_vector * dst, struct yf_vector * src) {
+
+    if (dst == src)
+        return -1;
+
+    if (src->len == 0)
+        return 0;
+
+    if (yf_vector_reserve(dst, dst->len + src->len))
+        return -1;
+
+    memcpy(dst->data + dst->len, src->data, sizeof (void *) * src->len);
+    dst->len += src->len;
+    yf_vector_destroy(src, 0);
+    return 0;
+
+}
+
+void yf_vector_destroy(struct yf_vector * vec, int free_elements) {
+
+    size_t i;
+
+    if (free_elements) {
+        for (i = 0; i < vec->len; ++i)
+            yf_free(vec->data[i]);
+    }
+
+    if (!vec->arena)
+        yf_free(vec->data);
+    yf_vector_init_in(vec, vec->arena);
+
+}
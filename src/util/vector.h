@@ -0,0 +1,77 @@
+/**
+ * A growable array of pointers.
+ */
+
+#ifndef UTIL_VECTOR_H
+#define UTIL_VECTOR_H
+
+#include <stddef.h>
+
+#include <util/allocator.h>
+
+/**
+ * The elements are stored contiguously, and the capacity is doubled whenever
+ * it runs out, so adding an element is amortized O(1). A vector with no
+ * elements doesn't allocate anything.
+ */
+struct yf_vector {
+    void ** data;
+    size_t len; /* Number of elements */
+    size_t cap; /* Number of elements that fit before growing */
+    struct yf_arena * arena; /* Where data comes from, NULL for the heap */
+};
+
+/**
+ * Initialize an empty vector.
+ */
+void yf_vector_init(struct yf_vector * vec);
+
+/**
+ * Initialize an empty vector whose storage is allocated from an arena. It
+ * doesn't need to be destroyed, unless the elements are to be freed.
+ */
+void yf_vector_init_in(struct yf_vector * vec, struct yf_arena * arena);
+
+/**
+ * Add an element to the end. Returns -1 if we've run out of memory, or 0
+ * otherwise.
+ */
+int yf_vector_push(struct yf_vector * vec, void * element);
+
+/**
+ * Make room for at least "cap" elements in total. Returns -1 if we've run out
+ * of memory, or 0 otherwise.
+ */
+int yf_vector_reserve(struct yf_vector * vec, size_t cap);
+
+/**
+ * Move all elements of src to the end of dst.
+ * src will be empty after the operation, if successful
+ */
+int yf_vector_merge(struct yf_vector * dst, struct yf_vector * src);
+
+/**
+ * Destroy a vector, freeing the elements too if free_elements is set.
+ */
+void yf_vector_destroy(struct yf_vector * vec, int free_elements);
+
+/**
+ * Get the element at index i, which must be less than the length.
+ */
+static inline void * yf_vector_get(const struct yf_vector * vec, size_t i) {
+    return vec->data[i];
+}
+
+/**
+ * Iterate over the elements in order. The position lives in the loop, not in
+ * the vector, so iterations over the same vector can be nested, or run from
+ * several readers at once.
+ * @param vec must be an lvalue that is safe to evaluate multiple times (like a variable)
+ * @param out an lvalue denoting the element
+ */
+#define YF_VECTOR_FOREACH(vec, out) \
+    for (size_t yf_vector_i_ = 0; \
+        yf_vector_i_ < (vec).len && ((out) = (vec).data[yf_vector_i_], 1); \
+        ++yf_vector_i_)
+
+#endif /* UTIL_VECTOR_H */
@@ -0,0 +1,111 @@
+/**
+ * Checks of the lexer's token reading and backtracking that no input file can
+ * reach through the parser. Run by ctest.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <api/lexer-input.h>
+#include <api/loc.h>
+#include <lexer/lexer.h>
+#include <util/intern.h>
+
+static int failures;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, \
+            #cond); \
+        ++failures; \
+    } \
+} while (0)
+
+enum yfl_mode {
+    MODE_STREAM, /* yfl_lex_all */
+    MODE_THREAD, /* yfl_lex_thread */
+};
+
+static const char * mode_name(enum yfl_mode mode) {
+    return mode == MODE_STREAM ? "stream" : "thread";
+}
+
+static int start(
+    struct yf_lexer * lexer, struct yf_lexer_input * input,
+    const char * src, enum yfl_mode mode
+) {
+    memset(input, 0, sizeof *input);
+    input->buffer = src;
+    input->buffer_len = strlen(src);
+    input->input_name = "test.yf";
+    input->identifier_prefix = "";
+    if (yfl_init(lexer, input))
+        return 1;
+    if (mode == MODE_STREAM ? yfl_lex_all(lexer) : yfl_lex_thread(lexer)) {
+        yfl_cleanup(lexer);
+        return 1;
+    }
+    return 0;
+}
+
+static bool is_ident(const struct yf_token * tok, const char * name) {
+    return tok->type == YFT_IDENTIFIER && tok->len == strlen(name)
+        && !memcmp(tok->text, name, tok->len);
+}
+
+/**
+ * Reading the end of file more than once, then unlexing as many times, must
+ * leave the lexer just before the first end of file.
+ */
+static void test_unlex_after_eof(enum yfl_mode mode) {
+
+    struct yf_lexer_input input;
+    struct yf_lexer lexer;
+    struct yf_token tok;
+
+    fprintf(stderr, "unlex after eof (%s)\n", mode_name(mode));
+    if (start(&lexer, &input, "a b", mode)) {
+        CHECK(!"lexer set up");
+        return;
+    }
+
+    yfl_lex(&lexer, &tok);
+    CHECK(is_ident(&tok, "a"));
+    yfl_lex(&lexer, &tok);
+    CHECK(is_ident(&tok, "b"));
+    yfl_lex(&lexer, &tok);
+    CHECK(tok.type == YFT_EOF);
+    yfl_lex(&lexer, &tok);
+    CHECK(tok.type == YFT_EOF);
+
+    CHECK(yfl_unlex(&lexer, &tok) == 0);
+    CHECK(yfl_unlex(&lexer, &tok) == 0);
+    yfl_lex(&lexer, &tok);
+    CHECK(tok.type == YFT_EOF);
+
+    /* One more step back is the last real token. */
+    CHECK(yfl_unlex(&lexer, &tok) == 0);
+    CHECK(yfl_unlex(&lexer, &tok) == 0);
+    yfl_lex(&lexer, &tok);
+    CHECK(is_ident(&tok, "b"));
+
+    yfl_cleanup(&lexer);
+
+}
+
+int main(void) {
+
+    test_unlex_after_eof(MODE_STREAM);
+    test_unlex_after_eof(MODE_THREAD);
+
+    yf_intern_cleanup();
+    yf_sources_cleanup();
+
+    if (failures) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+
+}